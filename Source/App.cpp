@@ -2,12 +2,46 @@
 
 #include "Log.hpp"
 
+#include <algorithm>
+#include <cctype>   // std::isspace
+#include <cerrno>
+#include <charconv> // std::from_chars
+#include <cmath>    // std::fmod, std::isfinite
+#include <cstdlib>  // std::strtof
+#include <thread>
 #include <type_traits> // std::is_same_v
 
 #if __has_include(<format>)
     #include <format>
 #endif
 
+namespace
+{
+    // Whole text must be valid number
+    template<typename T>
+    static bool ParseNumber(const std::string& text, T& result)
+    {
+        if(text.empty() || std::isspace(static_cast<unsigned char>(text.front())))
+            return false;
+
+        // Floating point std::from_chars is not available in all supported compilers
+        if constexpr(std::is_floating_point_v<T>)
+        {
+            char* end = nullptr;
+            errno     = 0;
+            result    = std::strtof(text.c_str(), &end);
+
+            return errno == 0 && end == text.data() + text.size() && std::isfinite(result);
+        }
+        else
+        {
+            const auto r = std::from_chars(text.data(), text.data() + text.size(), result);
+
+            return r.ec == std::errc() && r.ptr == text.data() + text.size();
+        }
+    }
+}
+
 EWAN::App::App() :
     Version {PROJECT_VERSION_MAJOR, PROJECT_VERSION_MINOR, PROJECT_VERSION_PATCH, PROJECT_VERSION_TWEAK}
 {}
@@ -35,6 +69,35 @@ bool EWAN::App::Init()
 {
     Finished = false;
 
+    // Must be set before window and content are used
+    Window.Headless  = Options.Headless;
+    Content.Headless = Options.Headless;
+
+    if(Options.FrameTime >= 0.0f)
+        Timing.FixedFrameTime = Options.FrameTime;
+    else if(Options.Headless)
+        Timing.FixedFrameTime = 1.0f / 60.0f;
+
+    Profiler.OutputCSV  = Options.ProfileCSV;
+    Profiler.OutputJSON = Options.ProfileJSON;
+
+    // Same events must be received in same frames, with same app clock
+    if(!Options.Replay.empty())
+    {
+        if(!Window.Record.StartReplay(Options.Replay))
+            return false;
+
+        Timing.FixedFrameTime = Window.Record.GetFrameTime();
+    }
+    else if(!Options.Record.empty())
+    {
+        if(Timing.FixedFrameTime <= 0.0f)
+            Timing.FixedFrameTime = 1.0f / 60.0f;
+
+        if(!Window.Record.StartRecord(Options.Record, Timing.FixedFrameTime))
+            return false;
+    }
+
     if(!GameInfo.Init())
         return false;
 
@@ -44,6 +107,14 @@ bool EWAN::App::Init()
     if(!Window.Init(Content))
         return false;
 
+    // Scripts can only insert sprites owned by Content::Sprite
+    Content.Sprite.CallbackPreDelete = [this](void* sprite) {
+        if(sprite)
+            Scene.RemoveSprite(static_cast<sf::Sprite*>(sprite));
+        else
+            Scene.Clear();
+    };
+
     if(!Script.Init(this))
         return false;
 
@@ -54,7 +125,11 @@ void EWAN::App::Finish()
 {
     Finished = true;
 
+    Profiler.Finish();
+    Window.Record.Finish(Timing.Frames);
     Script.Finish();
+    Scene.Clear(); // before sprites are deleted
+    Content.Sprite.CallbackPreDelete = nullptr;
     Window.Finish();
     Content.Finish();
     GameInfo.Finish();
@@ -69,21 +144,206 @@ void EWAN::App::MainLoop()
     Window.FPS.ClockFPS.restart();
     Window.FPS.ClockFrameTime.restart();
 
+    FrameTime         = std::chrono::steady_clock::now();
+    UpdateTime        = FrameTime;
+    UpdateAccumulator = 0.0;
+    Timing.Time       = 0.0;
+    Timing.Frames     = 0;
+
+    Profiler.Start();
+
     while(!Quit && !Restart)
     {
-        if(Window.isOpen())
-        {
+        auto phase = std::chrono::steady_clock::now();
+
+        if(Window.IsOpen())
             Window.Update(this);
+
+        UpdateFixed();
+        phase = Profiler.Record(Profiler::Phase::Update, phase);
+
+        if(Window.IsOpen())
             Window.Render(&Script);
-        }
+
+        phase = Profiler.Record(Profiler::Phase::Render, phase);
+
+        Script.Update();
+        Script.GarbageCollect(GetGarbageBudget());
+        Profiler.Record(Profiler::Phase::Maintenance, phase);
 
         // always last
         Window.UpdateFPS();
+        WaitForNextFrame();
+
+        Profiler.NextFrame();
+        Window.Hud.Update(this);
+
+        Timing.Frames++;
+        if(IsLimitReached())
+        {
+            Log::Raw("Limit reached : " + std::to_string(Timing.Frames) + " frame(s), " + std::to_string(Timing.Time) + " second(s)");
+            Quit = true;
+        }
     }
 
     Log::PrintInfo("END MAIN LOOP");
 }
 
+/* static */ bool EWAN::App::ParseOptions(const std::vector<std::string>& args, decltype(App::Options)& options)
+{
+    for(const std::string& arg : args)
+    {
+        const size_t      separator = arg.find('=');
+        const std::string name      = arg.substr(0, separator);
+        const std::string value     = separator != std::string::npos ? arg.substr(separator + 1) : std::string();
+
+        bool valid = true;
+
+        if(name == "--headless")
+            options.Headless = true;
+        else if(name == "--frames")
+            valid = ParseNumber(value, options.Frames);
+        else if(name == "--seconds")
+            valid = ParseNumber(value, options.Seconds) && options.Seconds >= 0.0f;
+        else if(name == "--frame-time")
+            valid = ParseNumber(value, options.FrameTime) && options.FrameTime >= 0.0f;
+        else if(name == "--profile-csv")
+        {
+            options.ProfileCSV = value;
+            valid              = !value.empty();
+        }
+        else if(name == "--profile-json")
+        {
+            options.ProfileJSON = value;
+            valid               = !value.empty();
+        }
+        else if(name == "--record")
+        {
+            options.Record = value;
+            valid          = !value.empty() && options.Replay.empty();
+        }
+        else if(name == "--replay")
+        {
+            options.Replay = value;
+            valid          = !value.empty() && options.Record.empty();
+        }
+        else
+        {
+            Log::PrintError("Unknown option : " + arg);
+            return false;
+        }
+
+        if(!valid)
+        {
+            Log::PrintError("Invalid option : " + arg);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool EWAN::App::IsLimitReached() const
+{
+    if(Options.Frames && Timing.Frames >= Options.Frames)
+        return true;
+
+    if(Options.Seconds > 0.0f && Timing.Time >= static_cast<double>(Options.Seconds))
+        return true;
+
+    if(Window.Record.IsFinished(Timing.Frames))
+        return true;
+
+    return false;
+}
+
+void EWAN::App::UpdateFixed()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    if(Timing.FixedFrameTime > 0.0f)
+        Timing.FrameDelta = Timing.FixedFrameTime;
+    else
+        Timing.FrameDelta = std::chrono::duration<float>(now - UpdateTime).count();
+
+    UpdateTime = now;
+
+    Timing.Time += static_cast<double>(Timing.FrameDelta);
+    UpdateAccumulator += static_cast<double>(Timing.FrameDelta);
+
+    Timing.UpdateSteps = 0;
+
+    if(Timing.UpdateStep <= 0.0f)
+    {
+        UpdateAccumulator = 0.0;
+        Timing.Alpha      = 0.0f;
+        return;
+    }
+
+    const double step = Timing.UpdateStep;
+
+    while(UpdateAccumulator >= step && Timing.UpdateSteps < Timing.UpdateMaxSteps && !Quit && !Restart)
+    {
+        Script.OnUpdate.Run(Timing.UpdateStep);
+
+        UpdateAccumulator -= step;
+        Timing.UpdateSteps++;
+    }
+
+    // Too far behind; drop whole steps, keep fraction
+    if(UpdateAccumulator >= step)
+        UpdateAccumulator = std::fmod(UpdateAccumulator, step);
+
+    Timing.Alpha = static_cast<float>(UpdateAccumulator / step);
+}
+
+uint32_t EWAN::App::GetGarbageBudget() const
+{
+    if(!Timing.FrameLimit || Options.Headless)
+        return Script.GarbageBudget;
+
+    // Time which would be otherwise spent on waiting for next frame
+    const auto frameEnd = FrameTime + std::chrono::duration<double>(1.0 / Timing.FrameLimit - Timing.SpinTime);
+    const auto slack    = std::chrono::duration_cast<std::chrono::microseconds>(frameEnd - std::chrono::steady_clock::now()).count();
+
+    return std::max(Script.GarbageBudget, static_cast<uint32_t>(std::max<int64_t>(slack, 0)));
+}
+
+void EWAN::App::WaitForNextFrame()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    Timing.SleepTime = 0.0f;
+
+    // Headless runs are used for benchmarks, there's no reason to wait
+    if(!Timing.FrameLimit || Options.Headless)
+    {
+        FrameTime = start;
+        return;
+    }
+
+    const auto frameEnd = FrameTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / Timing.FrameLimit));
+
+    // Running late; start next frame immediately, without trying to catch up
+    if(frameEnd <= start)
+    {
+        FrameTime = start;
+        return;
+    }
+
+    const auto spin = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(std::max(Timing.SpinTime, 0.0f)));
+    if(frameEnd - start > spin)
+        std::this_thread::sleep_for(frameEnd - start - spin);
+
+    while(std::chrono::steady_clock::now() < frameEnd)
+    {
+        std::this_thread::yield();
+    }
+
+    FrameTime        = frameEnd;
+    Timing.SleepTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+}
+
 //
 
 namespace
@@ -2,17 +2,81 @@
 
 #include "Content.hpp"
 #include "GameInfo.hpp"
+#include "Profiler.hpp"
+#include "Scene.hpp"
 #include "Script.hpp"
 #include "Window.hpp"
 
 #include "Libs/SFML.hpp"
 
+#include <chrono>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 namespace EWAN
 {
     class App
     {
+    public:
+        // Command line options, see ParseOptions()
+        struct Options
+        {
+            // Runs without window and GPU; see Window::Headless
+            bool Headless = false;
+
+            // Main loop stops after given amount of frames or seconds of app clock; disabled when zero
+            uint32_t Frames  = 0;
+            float    Seconds = 0.0f;
+
+            // Copied to Timing.FixedFrameTime; headless mode uses 1/60 unless set explicitly
+            float FrameTime = -1.0f;
+
+            // Copied to Profiler output files
+            std::string ProfileCSV;
+            std::string ProfileJSON;
+
+            // Window events are written to, or read from, given file; see InputRecord
+            // Both modes force fixed frame time, replay uses one stored in file
+            std::string Record;
+            std::string Replay;
+        };
+
+        // Main loop timing; all times are in seconds
+        struct Timing
+        {
+            // Length of single [OnUpdate] tick; fixed step updates are disabled when zero
+            float UpdateStep = 1.0f / 60.0f;
+
+            // Part of UpdateStep accumulated since last tick, in range [0, 1); allows scripts to interpolate rendered state
+            float Alpha = 0.0f;
+
+            // Maximum amount of ticks run during single frame; time left after that is dropped, so long stalls doesn't snowball
+            uint32_t UpdateMaxSteps = 5;
+
+            // Amount of ticks run during last frame
+            uint32_t UpdateSteps = 0;
+
+            // Maximum amount of frames per second; disabled when zero
+            uint32_t FrameLimit = 0;
+
+            // Time spent waiting for next frame, during last frame
+            float SleepTime = 0.0f;
+
+            // Last part of waiting is done by spinning, as sleep precision depends on OS scheduler
+            float SpinTime = 0.002f;
+
+            // When set, every frame advances app clock by exactly this amount instead of measured time, making updates deterministic
+            float FixedFrameTime = 0.0f;
+
+            // App clock advance during last frame
+            float FrameDelta = 0.0f;
+
+            // App clock, and amount of frames, since main loop start
+            double   Time   = 0.0;
+            uint32_t Frames = 0;
+        };
+
     public:
         const uint8_t Version[4];
 
@@ -26,6 +90,15 @@ namespace EWAN
         sf::Event::KeyEvent Keyboard;
         EWAN::Script        Script;
         EWAN::Window        Window;
+        EWAN::App::Options  Options;
+        EWAN::App::Timing   Timing;
+        EWAN::Profiler      Profiler;
+        EWAN::Scene         Scene;
+
+    private:
+        std::chrono::steady_clock::time_point FrameTime;  // start of current frame
+        std::chrono::steady_clock::time_point UpdateTime; // last fixed step update
+        double                                UpdateAccumulator = 0.0;
 
     public:
         App();
@@ -36,5 +109,21 @@ namespace EWAN
         void Finish();
 
         void MainLoop();
+
+        // Returns false on unknown or invalid option
+        static bool ParseOptions(const std::vector<std::string>& args, decltype(App::Options)& options);
+
+    protected:
+        // Returns true if main loop should stop because of frames/seconds limit
+        bool IsLimitReached() const;
+
+        // Advances app clock, and runs [OnUpdate] for every full UpdateStep since last call
+        void UpdateFixed();
+
+        // Returns time (in microseconds) garbage collector can use during current frame
+        uint32_t GetGarbageBudget() const;
+
+        // Waits until next frame should start, if frame limit is enabled
+        void WaitForNextFrame();
     };
 }
@@ -0,0 +1,201 @@
+#include "Batch.hpp"
+
+#include "Math.hpp"
+
+#include <algorithm>
+#include <cstdlib> // std::abs
+
+void EWAN::Batch::Add(const sf::Sprite& sprite)
+{
+    Add(sprite, Layer);
+}
+
+void EWAN::Batch::Add(const sf::Sprite& sprite, int32_t layer, const sf::BlendMode& blend /*= sf::BlendAlpha */)
+{
+    // Same geometry as sf::Sprite uses, in sf::Quads order
+
+    const sf::IntRect& rect   = sprite.getTextureRect();
+    const sf::Color&   color  = sprite.getColor();
+    const float        width  = static_cast<float>(std::abs(rect.width));
+    const float        height = static_cast<float>(std::abs(rect.height));
+    const float        left   = static_cast<float>(rect.left);
+    const float        top    = static_cast<float>(rect.top);
+    const float        right  = left + static_cast<float>(rect.width);
+    const float        bottom = top + static_cast<float>(rect.height);
+
+    sf::Vector2f positions[4] = {{0.0f, 0.0f}, {width, 0.0f}, {width, height}, {0.0f, height}};
+    Math::TransformPoints(sprite.getTransform(), positions, 4);
+
+    Commands.push_back({sprite.getTexture(), GetBlendIndex(blend), layer, static_cast<uint32_t>(CommandVertices.size()), 4, 0});
+
+    CommandVertices.emplace_back(positions[0], color, sf::Vector2f(left, top));
+    CommandVertices.emplace_back(positions[1], color, sf::Vector2f(right, top));
+    CommandVertices.emplace_back(positions[2], color, sf::Vector2f(right, bottom));
+    CommandVertices.emplace_back(positions[3], color, sf::Vector2f(left, bottom));
+}
+
+void EWAN::Batch::Add(const sf::VertexArray& vertices, const sf::Texture* texture, const sf::Transform& transform, int32_t layer, const sf::BlendMode& blend /*= sf::BlendAlpha */)
+{
+    const size_t count = vertices.getVertexCount();
+    if(!count)
+        return;
+
+    Commands.push_back({texture, GetBlendIndex(blend), layer, static_cast<uint32_t>(CommandVertices.size()), static_cast<uint32_t>(count), 0});
+
+    for(size_t v = 0; v < count; v++)
+    {
+        const sf::Vertex& vertex = vertices[v];
+        CommandVertices.emplace_back(transform.transformPoint(vertex.position), vertex.color, vertex.texCoords);
+    }
+}
+
+bool EWAN::Batch::IsEmpty() const
+{
+    return Commands.empty();
+}
+
+void EWAN::Batch::Clear()
+{
+    Commands.clear();
+    CommandVertices.clear();
+    Blends.clear();
+}
+
+void EWAN::Batch::Swap(Batch& other)
+{
+    Commands.swap(other.Commands);
+    CommandVertices.swap(other.CommandVertices);
+    Blends.swap(other.Blends);
+}
+
+void EWAN::Batch::Flush(sf::RenderTarget* target)
+{
+    Sprites   = static_cast<uint32_t>(Commands.size());
+    DrawCalls = 0;
+    Vertices  = static_cast<uint32_t>(CommandVertices.size());
+
+    if(Commands.empty())
+        return;
+
+    // Only layer decides order; sprites within same layer might overlap, and must be drawn in order in which they were added
+    std::stable_sort(Commands.begin(), Commands.end(), [](const Command& left, const Command& right) -> bool {
+        return left.Layer < right.Layer;
+    });
+
+    // Runs are created in drawing order, so sorting by run moves commands joining earlier runs without changing anything else
+    AssignRuns();
+    std::stable_sort(Commands.begin(), Commands.end(), [](const Command& left, const Command& right) -> bool {
+        return left.Run < right.Run;
+    });
+
+    // Copy vertices in sorted order, so every state change maps to single continuous range
+
+    FlushVertices.resize(CommandVertices.size());
+
+    size_t vertex = 0;
+    for(const Command& command : Commands)
+    {
+        std::copy_n(CommandVertices.begin() + command.Vertex, command.Count, FlushVertices.begin() + static_cast<std::ptrdiff_t>(vertex));
+        vertex += command.Count;
+    }
+
+    size_t first = 0, end = 0;
+    for(size_t c = 0; c < Commands.size(); c++)
+    {
+        const bool last = c + 1 == Commands.size();
+
+        end += Commands[c].Count;
+
+        // Layer change alone doesn't require new draw call, sorting already took care of order
+        if(last || Commands[c].Texture != Commands[c + 1].Texture || Commands[c].Blend != Commands[c + 1].Blend)
+        {
+            sf::RenderStates states(Blends[Commands[c].Blend]);
+            states.texture = Commands[c].Texture;
+
+            // Without target, everything except drawing is still done, and draw calls are counted as usual
+            if(target)
+                target->draw(FlushVertices.data() + first, end - first, sf::Quads, states);
+
+            DrawCalls++;
+
+            first = end;
+        }
+    }
+
+    Clear();
+}
+
+uint32_t EWAN::Batch::GetBlendIndex(const sf::BlendMode& blend)
+{
+    // Only few blend modes are expected per frame
+    auto it = std::find(Blends.begin(), Blends.end(), blend);
+    if(it != Blends.end())
+        return static_cast<uint32_t>(it - Blends.begin());
+
+    Blends.push_back(blend);
+
+    return static_cast<uint32_t>(Blends.size() - 1);
+}
+
+sf::FloatRect EWAN::Batch::GetBounds(const Command& command) const
+{
+    sf::Vector2f min = CommandVertices[command.Vertex].position;
+    sf::Vector2f max = min;
+
+    for(uint32_t v = 1; v < command.Count; v++)
+    {
+        const sf::Vector2f& position = CommandVertices[command.Vertex + v].position;
+
+        min.x = std::min(min.x, position.x);
+        min.y = std::min(min.y, position.y);
+        max.x = std::max(max.x, position.x);
+        max.y = std::max(max.y, position.y);
+    }
+
+    return sf::FloatRect(min, max - min);
+}
+
+void EWAN::Batch::AssignRuns()
+{
+    Runs.clear();
+
+    for(Command& command : Commands)
+    {
+        const sf::FloatRect bounds = GetBounds(command);
+        const size_t        first  = Runs.size() - std::min(Runs.size(), RunLookback);
+
+        command.Run = static_cast<uint32_t>(Runs.size());
+
+        // Command can be moved back to earlier run using same state, as long as it doesn't overlap anything drawn in between
+        for(size_t r = Runs.size(); r > first; r--)
+        {
+            const Run& run = Runs[r - 1];
+
+            if(run.Layer != command.Layer)
+                break;
+            else if(run.Texture == command.Texture && run.Blend == command.Blend)
+            {
+                command.Run = static_cast<uint32_t>(r - 1);
+                break;
+            }
+            else if(run.Bounds.intersects(bounds))
+                break;
+        }
+
+        if(command.Run == Runs.size())
+        {
+            Runs.push_back({command.Texture, command.Blend, command.Layer, bounds});
+            continue;
+        }
+
+        // Commands joining later runs must not overlap this one either
+        sf::FloatRect& runBounds = Runs[command.Run].Bounds;
+
+        const float left   = std::min(runBounds.left, bounds.left);
+        const float top    = std::min(runBounds.top, bounds.top);
+        const float right  = std::max(runBounds.left + runBounds.width, bounds.left + bounds.width);
+        const float bottom = std::max(runBounds.top + runBounds.height, bounds.top + bounds.height);
+
+        runBounds = sf::FloatRect(left, top, right - left, bottom - top);
+    }
+}
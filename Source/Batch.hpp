@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Libs/SFML.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace EWAN
+{
+    // Collects sprites drawn during single frame, and draws them with as few draw calls as possible
+    //
+    // Sprites are drawn by layer, and within layer in order in which they were added. New draw call starts whenever texture or
+    // blend mode changes; sprite can join earlier draw call using same state only if it doesn't overlap anything drawn in between
+    class Batch
+    {
+    public:
+        struct Command
+        {
+            const sf::Texture* Texture;
+            uint32_t           Blend;  // index in Blends
+            int32_t            Layer;
+            uint32_t           Vertex; // index of first vertex in Vertices
+            uint32_t           Count;  // amount of vertices, 4 for sprites
+            uint32_t           Run;    // index in Runs, assigned by Flush()
+        };
+
+        // Commands drawn with single draw call
+        struct Run
+        {
+            const sf::Texture* Texture;
+            uint32_t           Blend;
+            int32_t            Layer;
+            sf::FloatRect      Bounds; // covers all commands in run
+        };
+
+        // Amount of previous runs checked when looking for run which can be joined by command
+        static constexpr size_t RunLookback = 8;
+
+    public:
+        // Layer used by Add() when not given explicitly
+        int32_t Layer = 0;
+
+        // Results of last Flush(); vertex arrays added as whole are counted as single sprite
+        uint32_t Sprites   = 0;
+        uint32_t DrawCalls = 0;
+        uint32_t Vertices  = 0;
+
+    protected:
+        std::vector<Command>       Commands;
+        std::vector<sf::Vertex>    CommandVertices; // Command::Count per command, already transformed
+        std::vector<sf::Vertex>    FlushVertices;   // sorted copy of CommandVertices
+        std::vector<sf::BlendMode> Blends;
+        std::vector<Run>           Runs;
+
+    public:
+        void Add(const sf::Sprite& sprite);
+        void Add(const sf::Sprite& sprite, int32_t layer, const sf::BlendMode& blend = sf::BlendAlpha);
+
+        // Adds prebuilt quads (e.g. Tilemap chunk), which are always drawn together
+        void Add(const sf::VertexArray& vertices, const sf::Texture* texture, const sf::Transform& transform, int32_t layer, const sf::BlendMode& blend = sf::BlendAlpha);
+
+        bool IsEmpty() const;
+
+        // Drops collected sprites without drawing them
+        void Clear();
+
+        // Exchanges collected sprites with other batch; statistics and default layer are not exchanged
+        void Swap(Batch& other);
+
+        // Draws all collected sprites and clears batch
+        // Target can be null, in which case only statistics are updated
+        void Flush(sf::RenderTarget* target);
+
+    protected:
+        uint32_t      GetBlendIndex(const sf::BlendMode& blend);
+        sf::FloatRect GetBounds(const Command& command) const;
+
+        // Assigns run to each command; commands must be sorted by layer
+        void AssignRuns();
+    };
+}
@@ -2,6 +2,7 @@
 
 #include "Log.hpp"
 #include "Text.hpp"
+#include "Tilemap.hpp"
 
 #include <algorithm>
 #include <filesystem>
@@ -74,6 +75,59 @@ namespace
     {
         delete static_cast<sf::Texture*>(data);
     }
+
+    static void* NewTilemap()
+    {
+        return new EWAN::Tilemap;
+    }
+
+    static void DeleteTilemap(void* data)
+    {
+        delete static_cast<EWAN::Tilemap*>(data);
+    }
+
+    // Names of all Ids ever created, keyed by hash
+    struct Interned
+    {
+        std::unordered_map<uint64_t, std::string> Names;
+        sf::Mutex                                 Lock;
+    };
+
+    static Interned& GetInterned()
+    {
+        static Interned interned;
+
+        return interned;
+    }
+}
+
+//
+
+EWAN::Content::Id::Id(const std::string& name) :
+    Hash(MakeHash(name))
+{
+    Interned& interned = GetInterned();
+    sf::Lock  lock(interned.Lock);
+
+    const auto it = interned.Names.try_emplace(Hash, name).first;
+    if(it->second != name)
+    {
+#if __has_include(<format>)
+        Log::Raw(std::format("({}) ERROR : Hash collision with ({})", name, it->second));
+#else
+        Log::Raw("(" + name + ") ERROR : Hash collision with (" + it->second + ")");
+#endif
+    }
+}
+
+std::string EWAN::Content::Id::GetName() const
+{
+    Interned& interned = GetInterned();
+    sf::Lock  lock(interned.Lock);
+
+    const auto it = interned.Names.find(Hash);
+
+    return it != interned.Names.end() ? it->second : std::string();
 }
 
 //
@@ -131,11 +185,26 @@ EWAN::Content::Info* EWAN::Content::Cache::Attach(const std::string& id, void* d
         return nullptr;
     }
 
+    const uint64_t hash = Id::MakeHash(id);
+
+    sf::Lock lock(CacheLock);
+
+    if(IdMap.find(hash) != IdMap.end())
+    {
+#if __has_include(<format>)
+        Log::Raw(std::format("({}) ERROR : ID hash already in use", id));
+#else
+        Log::Raw("(" + id + ") ERROR : ID hash already in use");
+#endif
+
+        return nullptr;
+    }
+
     if(!info)
         info = new Info();
 
-    sf::Lock lock(CacheLock);
-    CacheMap.emplace(id, std::make_pair(data, info));
+    auto it = CacheMap.emplace(id, std::make_pair(data, info)).first;
+    IdMap.emplace(hash, &it->second);
 
     return info;
 }
@@ -151,12 +220,18 @@ void* EWAN::Content::Cache::Detach(const std::string& id)
 
         delete info;
         CacheMap.erase(id);
+        IdMap.erase(Id::MakeHash(id));
         return data;
     }
 
     return nullptr;
 }
 
+void* EWAN::Content::Cache::Detach(const Id& id)
+{
+    return Exists(id) ? Detach(id.GetName()) : nullptr;
+}
+
 bool EWAN::Content::Cache::Detach(const std::string& id, void*& data, EWAN::Content::Info*& info)
 {
     data = nullptr;
@@ -167,6 +242,7 @@ bool EWAN::Content::Cache::Detach(const std::string& id, void*& data, EWAN::Cont
         sf::Lock lock(CacheLock);
 
         CacheMap.erase(id);
+        IdMap.erase(Id::MakeHash(id));
         return true;
     }
 
@@ -187,12 +263,20 @@ void* EWAN::Content::Cache::New(const std::string& id)
     return data;
 }
 
+void* EWAN::Content::Cache::New(const Id& id)
+{
+    return New(id.GetName());
+}
+
 bool EWAN::Content::Cache::Delete(const std::string& id)
 {
     void* data = Detach(id);
 
     if(data)
     {
+        if(CallbackPreDelete)
+            CallbackPreDelete(data);
+
         CallbackDelete(data);
         return true;
     }
@@ -200,12 +284,20 @@ bool EWAN::Content::Cache::Delete(const std::string& id)
     return false;
 }
 
+bool EWAN::Content::Cache::Delete(const Id& id)
+{
+    return Exists(id) && Delete(id.GetName());
+}
+
 size_t EWAN::Content::Cache::DeleteAll()
 {
     size_t count = 0;
 
     // As CacheMap is cleared here, there's no need to Detach()
 
+    if(CallbackPreDelete)
+        CallbackPreDelete(nullptr);
+
     sf::Lock lock(CacheLock);
     for(const auto& it : CacheMap)
     {
@@ -215,6 +307,7 @@ size_t EWAN::Content::Cache::DeleteAll()
     }
 
     CacheMap.clear();
+    IdMap.clear();
 
     return count;
 }
@@ -270,6 +363,13 @@ bool EWAN::Content::Cache::Exists(const std::string& id) const
     return CacheMap.find(id) != CacheMap.end();
 }
 
+bool EWAN::Content::Cache::Exists(const Id& id) const
+{
+    sf::Lock lock(CacheLock);
+
+    return IdMap.find(id.Hash) != IdMap.end();
+}
+
 void* EWAN::Content::Cache::Get(const std::string& id, bool silent /*= false */) const
 {
     sf::Lock lock(CacheLock);
@@ -292,6 +392,26 @@ void* EWAN::Content::Cache::Get(const std::string& id, bool silent /*= false */)
     return nullptr;
 }
 
+void* EWAN::Content::Cache::Get(const Id& id, bool silent /*= false */) const
+{
+    sf::Lock lock(CacheLock);
+
+    auto it = IdMap.find(id.Hash);
+    if(it != IdMap.end())
+        return std::get<0>(*it->second);
+
+    if(!silent)
+    {
+#if __has_include(<format>)
+        Log::Raw(std::format("({}) ERROR", id.GetName()));
+#else
+        Log::Raw("(" + id.GetName() + ") ERROR");
+#endif
+    }
+
+    return nullptr;
+}
+
 const EWAN::Content::Info* EWAN::Content::Cache::GetInfo(const std::string& id, bool silent /* = false */) const
 {
     sf::Lock lock(CacheLock);
@@ -314,6 +434,26 @@ const EWAN::Content::Info* EWAN::Content::Cache::GetInfo(const std::string& id,
     return nullptr;
 }
 
+const EWAN::Content::Info* EWAN::Content::Cache::GetInfo(const Id& id, bool silent /* = false */) const
+{
+    sf::Lock lock(CacheLock);
+
+    auto it = IdMap.find(id.Hash);
+    if(it != IdMap.end())
+        return std::get<1>(*it->second);
+
+    if(!silent)
+    {
+#if __has_include(<format>)
+        Log::Raw(std::format("({}) ERROR", id.GetName()));
+#else
+        Log::Raw("(" + id.GetName() + ") ERROR");
+#endif
+    }
+
+    return nullptr;
+}
+
 bool EWAN::Content::Cache::GetDataInfo(const std::string& id, void*& data, EWAN::Content::Info*& info) const
 {
     data = nullptr;
@@ -341,7 +481,8 @@ EWAN::Content::Content() :
     RenderTexture("RenderTexture", NewRenderTexture, DeleteRenderTexture),
     SoundBuffer("SoundBuffer", NewSoundBuffer, DeleteSoundBuffer, {".wav"}),
     Sprite("Sprite", NewSprite, DeleteSprite),
-    Texture("Texture", NewTexture, DeleteTexture, {".png"})
+    Texture("Texture", NewTexture, DeleteTexture, {".png"}),
+    Tilemap("Tilemap", NewTilemap, DeleteTilemap)
 {
     // Ugly way to make sure all containers are supported by GetCache()
 
@@ -351,6 +492,7 @@ EWAN::Content::Content() :
     GetCache<sf::SoundBuffer>();
     GetCache<sf::Sprite>();
     GetCache<sf::Texture>();
+    GetCache<EWAN::Tilemap>();
 }
 
 EWAN::Content::~Content()
@@ -387,11 +529,14 @@ size_t EWAN::Content::DeleteAll()
 {
     size_t size = 0;
 
-    for(auto& cache : {&Font, &Image, &RenderTexture, &SoundBuffer, &Sprite, &Texture})
+    // Tilemaps are deleted first, as they're using textures
+    for(auto& cache : {&Tilemap, &Font, &Image, &RenderTexture, &SoundBuffer, &Sprite, &Texture})
     {
         size += cache->DeleteAll();
     }
 
+    PlaceholderSizes.clear();
+
     return size;
 }
 
@@ -399,7 +544,7 @@ size_t EWAN::Content::Size() const
 {
     size_t size = 0;
 
-    for(auto& cache : {&Font, &Image, &RenderTexture, &SoundBuffer, &Sprite, &Texture})
+    for(auto& cache : {&Font, &Image, &RenderTexture, &SoundBuffer, &Sprite, &Texture, &Tilemap})
     {
         size += cache->Size();
     }
@@ -407,6 +552,32 @@ size_t EWAN::Content::Size() const
     return size;
 }
 
+sf::Vector2u EWAN::Content::GetTextureSize(const sf::Texture& texture) const
+{
+    // Placeholder might have been deleted, and its memory reused by other texture
+    auto it = PlaceholderSizes.find(&texture);
+    if(it != PlaceholderSizes.end() && Texture.GetAs<sf::Texture>(it->second.first, true) == &texture)
+        return it->second.second;
+
+    return texture.getSize();
+}
+
+bool EWAN::Content::SetSpriteTexture(sf::Sprite& sprite, const sf::Texture& texture, bool resetRect) const
+{
+    // Same condition as used by sf::Sprite
+    const bool reset = resetRect || (!sprite.getTexture() && sprite.getTextureRect() == sf::IntRect());
+
+    sprite.setTexture(texture, resetRect);
+
+    if(reset && Headless)
+    {
+        const sf::Vector2u size = GetTextureSize(texture);
+        sprite.setTextureRect(sf::IntRect(0, 0, static_cast<int>(size.x), static_cast<int>(size.y)));
+    }
+
+    return true;
+}
+
 //
 
 template<typename T>
@@ -424,6 +595,8 @@ EWAN::Content::Cache& EWAN::Content::GetCache()
         return Sprite;
     else if constexpr(std::is_same_v<T, sf::Texture>)
         return Texture;
+    else if constexpr(std::is_same_v<T, EWAN::Tilemap>)
+        return Tilemap;
 }
 
 template<typename T>
@@ -479,7 +652,23 @@ bool EWAN::Content::LoadFile(const std::string& filename, const std::string& id)
     else if(std::find(SoundBuffer.Extensions.begin(), SoundBuffer.Extensions.end(), extension) != SoundBuffer.Extensions.end())
         return LoadFileInternal<sf::SoundBuffer>(filename, id) != nullptr;
     else if(std::find(Texture.Extensions.begin(), Texture.Extensions.end(), extension) != Texture.Extensions.end())
-        return LoadFileInternal<sf::Texture>(filename, id) != nullptr;
+    {
+        if(!Headless)
+            return LoadFileInternal<sf::Texture>(filename, id) != nullptr;
+
+        // Same decoding work as sf::Texture, without uploading result
+        const sf::Image* image = LoadFileInternal<sf::Image>(filename, id);
+        if(!image)
+            return false;
+
+        const sf::Texture* placeholder = Texture.Exists(id) ? Texture.GetAs<sf::Texture>(id) : Texture.NewAs<sf::Texture>(id);
+        if(!placeholder)
+            return false;
+
+        PlaceholderSizes[placeholder] = {id, image->getSize()};
+
+        return true;
+    }
 
     return false;
 }
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility> // pair
 #include <vector>
@@ -22,6 +23,39 @@ namespace EWAN
             virtual ~Info() {}
         };
 
+    public:
+        // Interned content identifier, compared and looked up by hash only
+        // Name is hashed once, when Id is created; scripts are expected to keep Ids in global variables,
+        // which moves hashing and interning to module build
+        class Id
+        {
+        public:
+            uint64_t Hash = 0;
+
+        public:
+            constexpr Id() = default;
+            explicit Id(const std::string& name);
+
+            // FNV-1a
+            static constexpr uint64_t MakeHash(std::string_view name)
+            {
+                uint64_t hash = 14695981039346656037ull;
+
+                for(const char c : name)
+                {
+                    hash ^= static_cast<uint8_t>(c);
+                    hash *= 1099511628211ull;
+                }
+
+                return hash;
+            }
+
+            // Returns name used to create Id, or empty string if Id has not been interned
+            std::string GetName() const;
+
+            constexpr bool operator==(const Id& other) const = default;
+        };
+
     public:
         class Cache : sf::NonCopyable
         {
@@ -31,10 +65,16 @@ namespace EWAN
             // Used by Content::LoadFile() to guess target cache
             std::vector<std::string> Extensions;
 
+            // Called before Delete() deletes data, and once before DeleteAll() with nullptr; allows data users to release it first
+            std::function<void(void*)> CallbackPreDelete;
+
         protected:
             std::unordered_map<std::string, std::pair<void*, Info*>> CacheMap;
             mutable sf::Mutex                                        CacheLock;
 
+            // Points to CacheMap values, keyed by Id::MakeHash() of CacheMap key
+            std::unordered_map<uint64_t, std::pair<void*, Info*>*> IdMap;
+
         private:
             typedef std::function<void*()>     CallbackNewFunction;
             typedef std::function<void(void*)> CallbackDeleteFunction;
@@ -59,6 +99,7 @@ namespace EWAN
             // Removes data from cache, deletes info
             // Returns cached data
             void* Detach(const std::string& id);
+            void* Detach(const Id& id);
 
             // Removes data from cache
             // Returns cached data and info
@@ -68,6 +109,7 @@ namespace EWAN
             // Supports default constructor only (new T())
             // Returns cached data
             void* New(const std::string& id);
+            void* New(const Id& id);
 
             template<typename T>
             T* NewAs(const std::string& id)
@@ -78,6 +120,7 @@ namespace EWAN
             // Removes data from cache and deletes it
             // Returns false if data cannot be found
             bool Delete(const std::string& id);
+            bool Delete(const Id& id);
 
             // Removes and deletes all data from cache
             // Returns amount of deleted entries
@@ -92,9 +135,11 @@ namespace EWAN
 
             // Returns true if data with given ID has been added to cache
             bool Exists(const std::string& id) const;
+            bool Exists(const Id& id) const;
 
             // Returns cached data
             void* Get(const std::string& id, bool silent = false) const;
+            void* Get(const Id& id, bool silent = false) const;
 
             template<typename T>
             T* GetAs(const std::string& id, bool silent = false) const
@@ -102,8 +147,15 @@ namespace EWAN
                 return static_cast<T*>(Get(id, silent));
             }
 
+            template<typename T>
+            T* GetAs(const Id& id, bool silent = false) const
+            {
+                return static_cast<T*>(Get(id, silent));
+            }
+
             // Returns cached info
             const Info* GetInfo(const std::string& id, bool silent = false) const;
+            const Info* GetInfo(const Id& id, bool silent = false) const;
 
             // Returns false if data with given ID wasn't added to cache
             bool GetDataInfo(const std::string& id, void*& data, Info*& info) const;
@@ -112,12 +164,22 @@ namespace EWAN
     public:
         std::string RootDirectory;
 
+        // Set by App before Init(), when running without GPU
+        // Textures are decoded into Image cache, and Texture cache receives empty placeholders using same ids;
+        // placeholders always reports zero size, see GetTextureSize()
+        bool Headless = false;
+
         Cache Font;
         Cache Image;
         Cache RenderTexture;
         Cache SoundBuffer;
         Cache Sprite;
         Cache Texture;
+        Cache Tilemap;
+
+    protected:
+        // Size of images decoded for headless placeholders; entry is valid only if placeholder is still cached using same id
+        std::unordered_map<const sf::Texture*, std::pair<std::string, sf::Vector2u>> PlaceholderSizes;
 
     public:
         Content();
@@ -133,6 +195,12 @@ namespace EWAN
         // Returns total size of all caches
         size_t Size() const;
 
+        // Returns texture size, or size of decoded image when texture is headless placeholder
+        sf::Vector2u GetTextureSize(const sf::Texture& texture) const;
+
+        // Same as sf::Sprite::setTexture(), but texture rect is reset to GetTextureSize()
+        bool SetSpriteTexture(sf::Sprite& sprite, const sf::Texture& texture, bool resetRect) const;
+
     protected:
         // Returns cache matching given type
         template<typename T>
@@ -0,0 +1,270 @@
+#include "Hud.hpp"
+
+#include "App.hpp"
+
+#include <algorithm>
+#include <charconv> // std::to_chars
+#include <chrono>
+#include <cstdio>  // std::snprintf
+#include <cstring> // std::memcmp, std::memcpy
+#include <limits>
+
+EWAN::Hud::Hud() :
+    GraphVertices(sf::Quads, GraphSize * 4)
+{
+    for(uint32_t index = 0; index < GraphSize; index++)
+    {
+        UpdateGraphBar(index, 0.0f);
+    }
+}
+
+EWAN::Hud::~Hud()
+{}
+
+//
+
+void EWAN::Hud::SetFont(const sf::Font& font, uint32_t characterSize)
+{
+    for(Panel& panel : Panels)
+    {
+        panel.Text.setFont(font);
+        panel.Text.setCharacterSize(characterSize);
+    }
+}
+
+void EWAN::Hud::Update(App* app)
+{
+    // Nothing is going to be drawn
+    if(!app->Window.FPS.Visible || app->Window.Headless)
+        return;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto& fps = app->Window.FPS;
+
+    if(GetVisible(PanelType::FPS))
+    {
+        // Frame time is averaged over last second, so text changes only when FPS counters does
+        Panel& panel = GetPanel(PanelType::FPS);
+        panel.Clear();
+
+        if(fps.Min != std::numeric_limits<uint16_t>::max())
+            panel.Append("FPS ").Append(fps.Count).Append(" min ").Append(fps.Min).Append(" max ").Append(fps.Max).Append(" | ").Append(fps.Count ? 1000.0f / fps.Count : 0.0f, 2).Append(" ms");
+    }
+
+    // Reports are added once per interval
+    if(GetVisible(PanelType::Profiler) && app->Profiler.GetReports().size() != ProfilerReports)
+    {
+        ProfilerReports = app->Profiler.GetReports().size();
+
+        const Profiler::Summary& frame = app->Profiler.GetLast(Profiler::Phase::Frame);
+
+        Panel& panel = GetPanel(PanelType::Profiler);
+        panel.Clear();
+        panel.Append("p50 ").Append(frame.P50, 2).Append(" p95 ").Append(frame.P95, 2).Append(" p99 ").Append(frame.P99, 2).Append(" max ").Append(frame.Max, 2).Append(" ms");
+    }
+
+    if(GetVisible(PanelType::Content))
+    {
+        Panel& panel = GetPanel(PanelType::Content);
+        panel.Clear();
+
+        for(const Content::Cache* cache : {&app->Content.Font, &app->Content.Image, &app->Content.RenderTexture, &app->Content.SoundBuffer, &app->Content.Sprite, &app->Content.Texture, &app->Content.Tilemap})
+        {
+            panel.Append(panel.GetText().empty() ? "" : " ").Append(cache->Name).Append(" ").Append(cache->Size());
+        }
+    }
+
+    if(GetVisible(PanelType::Script))
+    {
+        const Script::Memory::Stats& memory  = app->Script.MemoryStats;
+        const Script::GarbageStats&  garbage = app->Script.Garbage;
+
+        Panel& panel = GetPanel(PanelType::Script);
+        panel.Clear();
+        panel.Append("Memory ").Append(memory.Bytes / 1024).Append(" KiB, ").Append(memory.FrameAllocations).Append(" allocations");
+        panel.Append("\nGC ").Append(garbage.Alive).Append(" alive, ").Append(static_cast<uint64_t>(garbage.FrameTime)).Append(" us");
+    }
+
+    GraphSamples[GraphWritten % GraphSize] = fps.FrameTime;
+    GraphWritten++;
+
+    UpdateTime = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+void EWAN::Hud::Prepare()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    bool layout = GraphDrawn != GraphVisible;
+    GraphDrawn  = GraphVisible;
+
+    for(size_t type = 0; type < Panels.size(); type++)
+    {
+        if(Panels[type].Prepare(Visible[type]))
+            layout = true;
+    }
+
+    // Panels are stacked in order of PanelType, graph is placed below them
+    if(layout)
+    {
+        float top = 0.0f;
+        for(Panel& panel : Panels)
+        {
+            panel.Text.setPosition(0.0f, top);
+            top += static_cast<float>(panel.GetLines()) * LineHeight;
+        }
+
+        GraphTop = top;
+    }
+
+    // Only bars added since last call are changed; bar in front of newest one is cleared, to show where graph wraps
+    if(GraphDrawn && GraphShown != GraphWritten)
+    {
+        const uint64_t pending = std::min<uint64_t>(GraphWritten - GraphShown, GraphSize);
+
+        for(uint64_t sample = GraphWritten - pending; sample < GraphWritten; sample++)
+        {
+            UpdateGraphBar(static_cast<uint32_t>(sample % GraphSize), GraphSamples[sample % GraphSize]);
+        }
+
+        UpdateGraphBar(static_cast<uint32_t>(GraphWritten % GraphSize), 0.0f);
+    }
+
+    GraphShown = GraphWritten;
+
+    PrepareTime = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+void EWAN::Hud::Draw(sf::RenderTarget& target) const
+{
+    for(const Panel& panel : Panels)
+    {
+        if(panel.GetLines())
+            target.draw(panel.Text);
+    }
+
+    if(GraphDrawn && GraphShown)
+    {
+        sf::RenderStates states;
+        states.transform.translate(0.0f, GraphTop);
+
+        target.draw(GraphVertices, states);
+    }
+}
+
+EWAN::Hud::Panel& EWAN::Hud::GetPanel(PanelType type)
+{
+    return Panels[static_cast<size_t>(type)];
+}
+
+const EWAN::Hud::Panel& EWAN::Hud::GetPanel(PanelType type) const
+{
+    return Panels[static_cast<size_t>(type)];
+}
+
+bool EWAN::Hud::GetVisible(PanelType type) const
+{
+    return type < PanelType::Count && Visible[static_cast<size_t>(type)];
+}
+
+void EWAN::Hud::SetVisible(PanelType type, bool visible)
+{
+    if(type < PanelType::Count)
+        Visible[static_cast<size_t>(type)] = visible;
+}
+
+void EWAN::Hud::UpdateGraphBar(uint32_t index, float frameTime)
+{
+    const float height = std::min(frameTime / GraphMaxTime, 1.0f) * GraphHeight;
+    const float left   = static_cast<float>(index) * GraphBarWidth;
+    const float right  = left + GraphBarWidth;
+
+    sf::Color color = sf::Color::Green;
+    if(frameTime > 1.0f / 30.0f)
+        color = sf::Color::Red;
+    else if(frameTime > 1.0f / 55.0f)
+        color = sf::Color::Yellow;
+
+    sf::Vertex* quad = &GraphVertices[index * 4];
+
+    quad[0] = sf::Vertex(sf::Vector2f(left, GraphHeight - height), color);
+    quad[1] = sf::Vertex(sf::Vector2f(right, GraphHeight - height), color);
+    quad[2] = sf::Vertex(sf::Vector2f(right, GraphHeight), color);
+    quad[3] = sf::Vertex(sf::Vector2f(left, GraphHeight), color);
+}
+
+//
+// Hud::Panel
+//
+
+void EWAN::Hud::Panel::Clear()
+{
+    Length    = 0;
+    Buffer[0] = '\0';
+}
+
+EWAN::Hud::Panel& EWAN::Hud::Panel::Append(std::string_view text)
+{
+    const size_t size = std::min(text.size(), Capacity - 1 - Length);
+
+    std::memcpy(Buffer.data() + Length, text.data(), size);
+    Length += size;
+    Buffer[Length] = '\0';
+
+    return *this;
+}
+
+EWAN::Hud::Panel& EWAN::Hud::Panel::Append(uint64_t value)
+{
+    const std::to_chars_result result = std::to_chars(Buffer.data() + Length, Buffer.data() + Capacity - 1, value);
+    if(result.ec == std::errc())
+    {
+        Length         = static_cast<size_t>(result.ptr - Buffer.data());
+        Buffer[Length] = '\0';
+    }
+
+    return *this;
+}
+
+EWAN::Hud::Panel& EWAN::Hud::Panel::Append(float value, int precision)
+{
+    // Floating point std::to_chars is not available in all supported compilers
+    const int written = std::snprintf(Buffer.data() + Length, Capacity - Length, "%.*f", precision, static_cast<double>(value));
+    if(written > 0)
+        Length = std::min(Length + static_cast<size_t>(written), Capacity - 1);
+
+    Buffer[Length] = '\0';
+
+    return *this;
+}
+
+std::string_view EWAN::Hud::Panel::GetText() const
+{
+    return std::string_view(Buffer.data(), Length);
+}
+
+bool EWAN::Hud::Panel::Prepare(bool visible)
+{
+    bool result = visible != Visible;
+    Visible     = visible;
+
+    if(Visible && (Length != ShownLength || std::memcmp(Buffer.data(), Shown.data(), Length) != 0))
+    {
+        std::memcpy(Shown.data(), Buffer.data(), Length + 1);
+        ShownLength = Length;
+
+        Text.setString(Shown.data());
+        Changes++;
+
+        Lines  = ShownLength ? static_cast<uint32_t>(std::count(Shown.begin(), Shown.begin() + static_cast<std::ptrdiff_t>(ShownLength), '\n')) + 1 : 0;
+        result = true;
+    }
+
+    return result;
+}
+
+uint32_t EWAN::Hud::Panel::GetLines() const
+{
+    return Visible ? Lines : 0;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Libs/SFML.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace EWAN
+{
+    class App;
+
+    // Debug overlay drawn on top of everything else
+    //
+    // Update() runs on main thread, and only formats numbers into fixed buffers; Prepare() passes changed buffers to sf::Text,
+    // so glyph geometry is rebuilt only when displayed text actually changes. When pipelining, Prepare() is called while
+    // render thread is idle, and Draw() runs on render thread; Update() for next frame never touches anything used by Draw()
+    class Hud
+    {
+    public:
+        enum class PanelType : uint32_t
+        {
+            FPS,      // frames per second, updated once per second
+            Profiler, // frame time percentiles of last profiler interval
+            Content,  // amount of cached entries
+            Script,   // script memory and garbage collector
+
+            Count
+        };
+
+        // Single block of text, formatted without allocations
+        class Panel
+        {
+        public:
+            static constexpr size_t Capacity = 256;
+
+            sf::Text Text;
+
+            // Amount of times text has been passed to sf::Text
+            uint32_t Changes = 0;
+
+        protected:
+            std::array<char, Capacity> Buffer {};
+            std::array<char, Capacity> Shown {};
+            size_t                     Length      = 0;
+            size_t                     ShownLength = 0;
+
+            uint32_t Lines   = 0;
+            bool     Visible = false; // as passed to last Prepare()
+
+        public:
+            void Clear();
+
+            // Text which doesn't fit in buffer is dropped
+            Panel& Append(std::string_view text);
+            Panel& Append(uint64_t value);
+            Panel& Append(float value, int precision);
+
+            std::string_view GetText() const;
+
+            // Passes text to sf::Text if it has been changed since last call
+            // Returns true if panel size might have been changed
+            bool Prepare(bool visible);
+
+            // Returns zero when panel is not visible
+            uint32_t GetLines() const;
+        };
+
+        // Frame times graph, one bar per frame
+        static constexpr uint32_t GraphSize     = 120;
+        static constexpr float    GraphBarWidth = 2.0f;
+        static constexpr float    GraphHeight   = 48.0f;
+        static constexpr float    GraphMaxTime  = 1.0f / 20.0f; // seconds, full bar height
+
+        static constexpr float LineHeight = 16.0f;
+
+    public:
+        std::array<bool, static_cast<size_t>(PanelType::Count)> Visible = {true, true, false, false};
+
+        bool GraphVisible = true;
+
+        // Time spent in last Update() and Prepare(), in microseconds
+        float UpdateTime  = 0.0f;
+        float PrepareTime = 0.0f;
+
+    protected:
+        std::array<Panel, static_cast<size_t>(PanelType::Count)> Panels;
+
+        std::array<float, GraphSize> GraphSamples {};
+        uint64_t                     GraphWritten = 0; // total amount of samples added
+        uint64_t                     GraphShown   = 0; // total amount of samples passed to vertices
+        sf::VertexArray              GraphVertices;
+        float                        GraphTop   = 0.0f;
+        bool                         GraphDrawn = false; // as used by last Prepare()
+
+        size_t ProfilerReports = 0;
+
+    public:
+        Hud();
+        virtual ~Hud();
+
+    public:
+        void SetFont(const sf::Font& font, uint32_t characterSize);
+
+        void Update(App* app);
+        void Prepare();
+        void Draw(sf::RenderTarget& target) const;
+
+        Panel&       GetPanel(PanelType type);
+        const Panel& GetPanel(PanelType type) const;
+
+        bool GetVisible(PanelType type) const;
+        void SetVisible(PanelType type, bool visible);
+
+    protected:
+        void UpdateGraphBar(uint32_t index, float frameTime);
+    };
+}
@@ -0,0 +1,211 @@
+#include "InputRecord.hpp"
+
+#include "Log.hpp"
+
+#include <cstddef> // offsetof
+#include <cstring> // std::memcpy
+#include <filesystem>
+#include <iterator>
+
+namespace
+{
+    // All event types keep their data in same union
+    static constexpr size_t EventDataOffset = offsetof(sf::Event, size);
+}
+
+EWAN::InputRecord::InputRecord()
+{}
+
+EWAN::InputRecord::~InputRecord()
+{
+    if(Output.is_open())
+        Output.close();
+}
+
+//
+
+bool EWAN::InputRecord::StartRecord(const std::string& filename, float frameTime)
+{
+    Output.open(filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if(!Output.is_open())
+    {
+        Log::PrintError("Input record : cannot write " + std::filesystem::path(filename).make_preferred().string());
+        return false;
+    }
+
+    Output.write(Magic, sizeof(Magic));
+    Output.write(reinterpret_cast<const char*>(&Version), sizeof(Version));
+    Output.write(reinterpret_cast<const char*>(&frameTime), sizeof(frameTime));
+
+    Current   = Mode::Record;
+    FrameTime = frameTime;
+
+    Log::Raw("Input record : " + std::filesystem::path(filename).make_preferred().string());
+
+    return true;
+}
+
+bool EWAN::InputRecord::StartReplay(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios_base::in | std::ios_base::binary);
+    if(!file.is_open())
+    {
+        Log::PrintError("Input replay : cannot read " + std::filesystem::path(filename).make_preferred().string());
+        return false;
+    }
+
+    Input.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    InputPosition = sizeof(Magic) + sizeof(Version) + sizeof(FrameTime);
+
+    if(Input.size() < InputPosition || std::memcmp(Input.data(), Magic, sizeof(Magic)) != 0 || static_cast<uint8_t>(Input[sizeof(Magic)]) != Version)
+    {
+        Log::PrintError("Input replay : invalid file " + std::filesystem::path(filename).make_preferred().string());
+        Input.clear();
+        return false;
+    }
+
+    std::memcpy(&FrameTime, Input.data() + sizeof(Magic) + sizeof(Version), sizeof(FrameTime));
+
+    Current  = Mode::Replay;
+    EndFrame = std::numeric_limits<uint32_t>::max();
+    End      = false;
+
+    Log::Raw("Input replay : " + std::filesystem::path(filename).make_preferred().string());
+
+    return true;
+}
+
+void EWAN::InputRecord::Finish(uint32_t frame)
+{
+    if(Current == Mode::Record)
+    {
+        Output.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+        Output.write(reinterpret_cast<const char*>(&EndType), sizeof(EndType));
+        Output.close();
+    }
+
+    Input.clear();
+    Current = Mode::None;
+}
+
+//
+
+EWAN::InputRecord::Mode EWAN::InputRecord::GetMode() const
+{
+    return Current;
+}
+
+float EWAN::InputRecord::GetFrameTime() const
+{
+    return FrameTime;
+}
+
+void EWAN::InputRecord::Write(uint32_t frame, const sf::Event& event)
+{
+    const uint8_t type = static_cast<uint8_t>(event.type);
+    size_t        size = 0;
+
+    if(Current != Mode::Record || !GetDataSize(type, size))
+        return;
+
+    Output.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+    Output.write(reinterpret_cast<const char*>(&type), sizeof(type));
+    Output.write(reinterpret_cast<const char*>(&event) + EventDataOffset, static_cast<std::streamsize>(size));
+}
+
+bool EWAN::InputRecord::Read(uint32_t frame, sf::Event& event)
+{
+    if(Current != Mode::Replay || End)
+        return false;
+
+    uint32_t recordFrame = 0;
+    uint8_t  type        = 0;
+    size_t   size        = 0;
+
+    if(InputPosition + sizeof(recordFrame) + sizeof(type) > Input.size())
+    {
+        // Recording has not been finished properly; stop feeding events, but let app run
+        Log::PrintWarning("Input replay : unexpected end of file");
+        End = true;
+        return false;
+    }
+
+    std::memcpy(&recordFrame, Input.data() + InputPosition, sizeof(recordFrame));
+    std::memcpy(&type, Input.data() + InputPosition + sizeof(recordFrame), sizeof(type));
+
+    // End marker is handled as soon as it's reached, so replay stops after same amount of frames as recording
+    if(type == EndType)
+    {
+        EndFrame = recordFrame;
+        End      = true;
+        return false;
+    }
+
+    if(recordFrame > frame)
+        return false;
+
+    if(!GetDataSize(type, size) || InputPosition + sizeof(recordFrame) + sizeof(type) + size > Input.size())
+    {
+        Log::PrintError("Input replay : invalid record, type " + std::to_string(type));
+        End = true;
+        return false;
+    }
+
+    InputPosition += sizeof(recordFrame) + sizeof(type);
+
+    event      = sf::Event();
+    event.type = static_cast<sf::Event::EventType>(type);
+    std::memcpy(reinterpret_cast<char*>(&event) + EventDataOffset, Input.data() + InputPosition, size);
+
+    InputPosition += size;
+
+    return true;
+}
+
+bool EWAN::InputRecord::IsFinished(uint32_t frame) const
+{
+    return Current == Mode::Replay && frame >= EndFrame;
+}
+
+//
+
+/* static */ bool EWAN::InputRecord::GetDataSize(uint8_t type, size_t& size)
+{
+    switch(static_cast<sf::Event::EventType>(type))
+    {
+        case sf::Event::Closed:
+        case sf::Event::LostFocus:
+        case sf::Event::GainedFocus:
+        case sf::Event::MouseEntered:
+        case sf::Event::MouseLeft:
+            size = 0;
+            return true;
+        case sf::Event::Resized:
+            size = sizeof(sf::Event::SizeEvent);
+            return true;
+        case sf::Event::TextEntered:
+            size = sizeof(sf::Event::TextEvent);
+            return true;
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+            size = sizeof(sf::Event::KeyEvent);
+            return true;
+        case sf::Event::MouseWheelMoved:
+            size = sizeof(sf::Event::MouseWheelEvent);
+            return true;
+        case sf::Event::MouseWheelScrolled:
+            size = sizeof(sf::Event::MouseWheelScrollEvent);
+            return true;
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            size = sizeof(sf::Event::MouseButtonEvent);
+            return true;
+        case sf::Event::MouseMoved:
+            size = sizeof(sf::Event::MouseMoveEvent);
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
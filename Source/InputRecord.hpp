@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Libs/SFML.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace EWAN
+{
+    // Writes window events to binary file, and reads them back in same frames they were received
+    //
+    // File starts with header (magic, version, frame time), followed by records : frame index (uint32), event type (uint8) and event data;
+    // data size depends on event type, and unsupported events (joystick, touch, sensors) are not recorded at all
+    // Last record uses EndType, and marks frame in which recording has been finished
+    // Values are stored in native byte order, files are not meant to be moved between platforms
+    class InputRecord
+    {
+    public:
+        enum class Mode : uint8_t
+        {
+            None,
+            Record,
+            Replay
+        };
+
+        static constexpr char    Magic[4] = {'E', 'W', 'I', 'R'};
+        static constexpr uint8_t Version  = 1;
+        static constexpr uint8_t EndType  = 0xFF;
+
+    protected:
+        Mode Current = Mode::None;
+
+        std::ofstream     Output;
+        std::vector<char> Input;
+        size_t            InputPosition = 0;
+
+        float    FrameTime = 0.0f;
+        uint32_t EndFrame  = std::numeric_limits<uint32_t>::max();
+        bool     End       = false; // no more records to read
+
+    public:
+        InputRecord();
+        virtual ~InputRecord();
+
+    public:
+        bool StartRecord(const std::string& filename, float frameTime);
+        bool StartReplay(const std::string& filename);
+
+        // Closes file; when recording, marks given frame as last one
+        void Finish(uint32_t frame);
+
+        Mode  GetMode() const;
+        float GetFrameTime() const;
+
+        void Write(uint32_t frame, const sf::Event& event);
+
+        // Returns next event recorded during given frame, or false if there's no more events for that frame
+        bool Read(uint32_t frame, sf::Event& event);
+
+        // Returns true if replay reached frame in which recording has been finished
+        bool IsFinished(uint32_t frame) const;
+
+    protected:
+        // Returns false for unsupported event types
+        static bool GetDataSize(uint8_t type, size_t& size);
+    };
+}
@@ -3,19 +3,26 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <string>
+#include <vector>
 
-auto main() -> int
+auto main(int argc, char* argv[]) -> int
 {
     // Disable console buffering
     std::setvbuf(stdout, nullptr, _IONBF, 0);
     std::setvbuf(stderr, nullptr, _IONBF, 0);
 
+    decltype(EWAN::App::Options) options;
+    if(!EWAN::App::ParseOptions(std::vector<std::string>(argv + 1, argv + argc), options))
+        return EXIT_FAILURE;
+
     bool restart = true;
     while(restart)
     {
         EWAN::Log::PrintInfo("BEGIN PROGRAM");
 
         EWAN::App* app = new EWAN::App;
+        app->Options   = options;
 
         app->Run();
         restart = app->Restart;
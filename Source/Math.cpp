@@ -0,0 +1,103 @@
+#include "Math.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define EWAN_MATH_SSE2
+    #include <emmintrin.h>
+#endif
+
+static_assert(sizeof(sf::Vector2f) == sizeof(float) * 2, "sf::Vector2f must be tightly packed");
+
+/* static */ float EWAN::Math::Dot(const sf::Vector2f& left, const sf::Vector2f& right)
+{
+    return left.x * right.x + left.y * right.y;
+}
+
+/* static */ float EWAN::Math::Length(const sf::Vector2f& vector)
+{
+    return std::sqrt(Dot(vector, vector));
+}
+
+/* static */ void EWAN::Math::TransformPoints(const sf::Transform& transform, sf::Vector2f* points, size_t count)
+{
+    // 4x4 column major matrix, only 2D part is used
+    const float* matrix = transform.getMatrix();
+    size_t       p      = 0;
+
+#if defined(EWAN_MATH_SSE2)
+    // Two points per register : x0 y0 x1 y1
+    const __m128 column0 = _mm_setr_ps(matrix[0], matrix[1], matrix[0], matrix[1]);
+    const __m128 column1 = _mm_setr_ps(matrix[4], matrix[5], matrix[4], matrix[5]);
+    const __m128 column3 = _mm_setr_ps(matrix[12], matrix[13], matrix[12], matrix[13]);
+
+    for(; p + 2 <= count; p += 2)
+    {
+        float* data = &points[p].x;
+
+        const __m128 xy = _mm_loadu_ps(data);
+        const __m128 xx = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 yy = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(3, 3, 1, 1));
+
+        _mm_storeu_ps(data, _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, column0), _mm_mul_ps(yy, column1)), column3));
+    }
+#endif
+
+    for(; p < count; p++)
+    {
+        const sf::Vector2f point = points[p];
+
+        points[p].x = matrix[0] * point.x + matrix[4] * point.y + matrix[12];
+        points[p].y = matrix[1] * point.x + matrix[5] * point.y + matrix[13];
+    }
+}
+
+/* static */ sf::FloatRect EWAN::Math::GetBounds(const sf::Vector2f* points, size_t count)
+{
+    if(!count)
+        return sf::FloatRect();
+
+    sf::Vector2f min = points[0];
+    sf::Vector2f max = points[0];
+    size_t       p   = 1;
+
+#if defined(EWAN_MATH_SSE2)
+    if(count >= 3)
+    {
+        // Each register keeps two independent min/max pairs, merged after loop
+        __m128 min4 = _mm_loadu_ps(&points[1].x);
+        __m128 max4 = min4;
+
+        for(p = 3; p + 2 <= count; p += 2)
+        {
+            const __m128 xy = _mm_loadu_ps(&points[p].x);
+
+            min4 = _mm_min_ps(min4, xy);
+            max4 = _mm_max_ps(max4, xy);
+        }
+
+        min4 = _mm_min_ps(min4, _mm_movehl_ps(min4, min4));
+        max4 = _mm_max_ps(max4, _mm_movehl_ps(max4, max4));
+
+        alignas(16) float result[8];
+        _mm_store_ps(result, min4);
+        _mm_store_ps(result + 4, max4);
+
+        min.x = std::min(min.x, result[0]);
+        min.y = std::min(min.y, result[1]);
+        max.x = std::max(max.x, result[4]);
+        max.y = std::max(max.y, result[5]);
+    }
+#endif
+
+    for(; p < count; p++)
+    {
+        min.x = std::min(min.x, points[p].x);
+        min.y = std::min(min.y, points[p].y);
+        max.x = std::max(max.x, points[p].x);
+        max.y = std::max(max.y, points[p].y);
+    }
+
+    return sf::FloatRect(min, max - min);
+}
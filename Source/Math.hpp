@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Libs/SFML.hpp"
+
+#include <cstddef>
+
+namespace EWAN
+{
+    struct Math
+    {
+        static float Dot(const sf::Vector2f& left, const sf::Vector2f& right);
+        static float Length(const sf::Vector2f& vector);
+
+        // Transforms all points in place
+        static void TransformPoints(const sf::Transform& transform, sf::Vector2f* points, size_t count);
+
+        // Returns smallest rectangle containing all points, or empty rectangle if there are no points
+        static sf::FloatRect GetBounds(const sf::Vector2f* points, size_t count);
+    };
+}
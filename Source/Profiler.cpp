@@ -0,0 +1,331 @@
+#include "Profiler.hpp"
+
+#include "Log.hpp"
+
+#include "Libs/JSON.hpp"
+
+#include <algorithm>
+#include <bit> // std::countl_zero
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+//
+// Histogram
+//
+
+void EWAN::Histogram::Record(uint32_t value)
+{
+    Counts[GetIndex(value)]++;
+
+    Sum += value;
+    Count++;
+    Max = std::max(Max, value);
+}
+
+void EWAN::Histogram::Add(const Histogram& other)
+{
+    for(uint32_t b = 0; b < BucketCount; b++)
+    {
+        Counts[b] += other.Counts[b];
+    }
+
+    Sum += other.Sum;
+    Count += other.Count;
+    Max = std::max(Max, other.Max);
+}
+
+void EWAN::Histogram::Reset()
+{
+    Counts.fill(0);
+
+    Sum   = 0;
+    Count = 0;
+    Max   = 0;
+}
+
+uint32_t EWAN::Histogram::GetCount() const
+{
+    return Count;
+}
+
+uint32_t EWAN::Histogram::GetMax() const
+{
+    return Max;
+}
+
+uint32_t EWAN::Histogram::GetMean() const
+{
+    return Count ? static_cast<uint32_t>(Sum / Count) : 0;
+}
+
+uint32_t EWAN::Histogram::GetPercentile(double percentile) const
+{
+    if(!Count)
+        return 0;
+
+    // Amount of values which must be lower or equal to result
+    const double   wanted = std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * Count);
+    const uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(wanted), 1);
+
+    uint64_t seen = 0;
+    for(uint32_t b = 0; b < BucketCount; b++)
+    {
+        seen += Counts[b];
+        if(seen >= target)
+            return std::min(GetValue(b), Max);
+    }
+
+    return Max;
+}
+
+/* static */ uint32_t EWAN::Histogram::GetIndex(uint32_t value)
+{
+    // First SubBucketCount values are stored exactly
+    if(value < SubBucketCount)
+        return value;
+
+    const uint32_t shift = static_cast<uint32_t>(31 - std::countl_zero(value)) - SubBucketBits;
+
+    return (shift + 1) * SubBucketCount + (value >> shift) - SubBucketCount;
+}
+
+/* static */ uint32_t EWAN::Histogram::GetValue(uint32_t index)
+{
+    if(index < SubBucketCount)
+        return index;
+
+    const uint32_t shift = index / SubBucketCount - 1;
+    const uint64_t sub   = index % SubBucketCount + SubBucketCount;
+
+    return static_cast<uint32_t>(std::min<uint64_t>(((sub + 1) << shift) - 1, UINT32_MAX));
+}
+
+//
+// Profiler
+//
+
+void EWAN::Profiler::Start()
+{
+    for(Histogram& histogram : Current)
+    {
+        histogram.Reset();
+    }
+
+    for(Histogram& histogram : Total)
+    {
+        histogram.Reset();
+    }
+
+    Reports.clear();
+    TotalReport = {};
+
+    StartTime = IntervalTime = FrameTime = std::chrono::steady_clock::now();
+}
+
+void EWAN::Profiler::Finish()
+{
+    // Last interval is usually incomplete; short runs might not complete any
+    if(std::any_of(Current.begin(), Current.end(), [](const Histogram& histogram) { return histogram.GetCount() > 0; }))
+        AddReport();
+
+    if(Reports.empty())
+        return;
+
+    const Summary& frame = GetTotal(Phase::Frame);
+    Log::Raw("Frame time : p50 = " + std::to_string(frame.P50) + "ms, p95 = " + std::to_string(frame.P95) + "ms, p99 = " + std::to_string(frame.P99) + "ms, max = " + std::to_string(frame.Max) + "ms, frames = " + std::to_string(frame.Count));
+
+    if(!OutputCSV.empty())
+        WriteCSV(OutputCSV);
+
+    if(!OutputJSON.empty())
+        WriteJSON(OutputJSON);
+}
+
+std::chrono::steady_clock::time_point EWAN::Profiler::Record(Phase phase, const std::chrono::steady_clock::time_point& since)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    if(Enabled && phase < Phase::Count)
+    {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - since).count();
+
+        Current[static_cast<size_t>(phase)].Record(static_cast<uint32_t>(std::clamp<int64_t>(elapsed, 0, UINT32_MAX)));
+    }
+
+    return now;
+}
+
+bool EWAN::Profiler::NextFrame()
+{
+    FrameTime = Record(Phase::Frame, FrameTime);
+
+    if(std::chrono::duration<float>(FrameTime - IntervalTime).count() < Interval)
+        return false;
+
+    IntervalTime = FrameTime;
+
+    AddReport();
+
+    return true;
+}
+
+const EWAN::Profiler::Summary& EWAN::Profiler::GetLast(Phase phase) const
+{
+    static const Summary empty;
+
+    if(Reports.empty() || phase >= Phase::Count)
+        return empty;
+
+    return Reports.back().Phases[static_cast<size_t>(phase)];
+}
+
+const EWAN::Profiler::Summary& EWAN::Profiler::GetTotal(Phase phase) const
+{
+    static const Summary empty;
+
+    if(phase >= Phase::Count)
+        return empty;
+
+    return TotalReport.Phases[static_cast<size_t>(phase)];
+}
+
+const std::vector<EWAN::Profiler::Report>& EWAN::Profiler::GetReports() const
+{
+    return Reports;
+}
+
+bool EWAN::Profiler::WriteCSV(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios_base::out | std::ios_base::trunc);
+    if(!file.is_open())
+    {
+        Log::PrintError("Profiler : cannot write " + std::filesystem::path(filename).make_preferred().string());
+        return false;
+    }
+
+    file << "time,phase,count,p50,p95,p99,max,mean\n";
+
+    for(const Report& report : Reports)
+    {
+        for(size_t p = 0; p < static_cast<size_t>(Phase::Count); p++)
+        {
+            const Summary& summary = report.Phases[p];
+
+            file << report.Time << ',' << GetPhaseName(static_cast<Phase>(p)) << ',' << summary.Count << ',' << summary.P50 << ',' << summary.P95 << ',' << summary.P99 << ',' << summary.Max << ',' << summary.Mean << '\n';
+        }
+    }
+
+    return file.good();
+}
+
+bool EWAN::Profiler::WriteJSON(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios_base::out | std::ios_base::trunc);
+    if(!file.is_open())
+    {
+        Log::PrintError("Profiler : cannot write " + std::filesystem::path(filename).make_preferred().string());
+        return false;
+    }
+
+    auto toJSON = [](const Summary& summary) -> nl::json {
+        return {
+            {"count", summary.Count},
+            {"p50", summary.P50},
+            {"p95", summary.P95},
+            {"p99", summary.P99},
+            {"max", summary.Max},
+            {"mean", summary.Mean}
+            //
+        };
+    };
+
+    nl::json total     = nl::json::object();
+    nl::json intervals = nl::json::array();
+
+    for(size_t p = 0; p < static_cast<size_t>(Phase::Count); p++)
+    {
+        total[GetPhaseName(static_cast<Phase>(p))] = toJSON(GetTotal(static_cast<Phase>(p)));
+    }
+
+    for(const Report& report : Reports)
+    {
+        nl::json interval = nl::json::object();
+        interval["time"]  = report.Time;
+
+        for(size_t p = 0; p < static_cast<size_t>(Phase::Count); p++)
+        {
+            interval[GetPhaseName(static_cast<Phase>(p))] = toJSON(report.Phases[p]);
+        }
+
+        intervals.push_back(interval);
+    }
+
+    nl::json json = nl::json::object();
+    json["interval"]  = Interval;
+    json["total"]     = total;
+    json["intervals"] = intervals;
+
+    file << json.dump(4) << '\n';
+
+    return file.good();
+}
+
+/* static */ std::string EWAN::Profiler::GetPhaseName(Phase phase)
+{
+    switch(phase)
+    {
+        case Phase::Frame:
+            return "frame";
+        case Phase::Update:
+            return "update";
+        case Phase::Render:
+            return "render";
+        case Phase::Maintenance:
+            return "maintenance";
+        case Phase::Count:
+            break;
+    }
+
+    return "unknown";
+}
+
+/* static */ EWAN::Profiler::Summary EWAN::Profiler::GetSummary(const Histogram& histogram)
+{
+    // Microseconds to milliseconds
+    auto ms = [](uint32_t value) -> float {
+        return static_cast<float>(value) / 1000.0f;
+    };
+
+    Summary summary;
+    summary.P50   = ms(histogram.GetPercentile(50.0));
+    summary.P95   = ms(histogram.GetPercentile(95.0));
+    summary.P99   = ms(histogram.GetPercentile(99.0));
+    summary.Max   = ms(histogram.GetMax());
+    summary.Mean  = ms(histogram.GetMean());
+    summary.Count = histogram.GetCount();
+
+    return summary;
+}
+
+//
+
+void EWAN::Profiler::AddReport()
+{
+    Report report;
+    report.Time = std::chrono::duration<float>(FrameTime - StartTime).count();
+
+    TotalReport.Time = report.Time;
+
+    for(size_t p = 0; p < static_cast<size_t>(Phase::Count); p++)
+    {
+        report.Phases[p] = GetSummary(Current[p]);
+
+        Total[p].Add(Current[p]);
+        Current[p].Reset();
+
+        TotalReport.Phases[p] = GetSummary(Total[p]);
+    }
+
+    Reports.push_back(report);
+}
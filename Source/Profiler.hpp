@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace EWAN
+{
+    // Log-linear histogram of durations in microseconds, similar to HdrHistogram
+    //
+    // Every power of two range is split into SubBucketCount linear buckets, so reported values are within ~3% of recorded ones
+    // while whole uint32 range fits in less than 1k counters
+    class Histogram
+    {
+    public:
+        static constexpr uint32_t SubBucketBits  = 5;
+        static constexpr uint32_t SubBucketCount = 1 << SubBucketBits;
+        static constexpr uint32_t BucketCount    = (32 - SubBucketBits + 1) * SubBucketCount;
+
+    protected:
+        std::array<uint32_t, BucketCount> Counts {};
+
+        uint64_t Sum   = 0;
+        uint32_t Count = 0;
+        uint32_t Max   = 0;
+
+    public:
+        void Record(uint32_t value);
+        void Add(const Histogram& other);
+        void Reset();
+
+        uint32_t GetCount() const;
+        uint32_t GetMax() const;
+        uint32_t GetMean() const;
+
+        // Returns highest value equivalent to bucket containing given percentile (in range [0, 100])
+        uint32_t GetPercentile(double percentile) const;
+
+        static uint32_t GetIndex(uint32_t value);
+        static uint32_t GetValue(uint32_t index);
+    };
+
+    // Records time spent in main loop phases, and reports percentiles for every interval
+    class Profiler
+    {
+    public:
+        enum class Phase : uint32_t
+        {
+            Frame,       // whole frame, including waiting for next one
+            Update,      // events and [OnUpdate]
+            Render,      // [OnDraw] and drawing
+            Maintenance, // Script::Update() and garbage collection; event callbacks are part of Update and Render
+
+            Count
+        };
+
+        // Times are in milliseconds
+        struct Summary
+        {
+            float P50  = 0.0f;
+            float P95  = 0.0f;
+            float P99  = 0.0f;
+            float Max  = 0.0f;
+            float Mean = 0.0f;
+
+            uint32_t Count = 0;
+        };
+
+        struct Report
+        {
+            float Time = 0.0f; // seconds since Start(), at end of interval
+
+            std::array<Summary, static_cast<size_t>(Phase::Count)> Phases;
+        };
+
+    public:
+        bool  Enabled  = true;
+        float Interval = 1.0f; // seconds
+
+        // Reports are written to given files by Finish(); output is disabled when filename is empty
+        std::string OutputCSV;
+        std::string OutputJSON;
+
+    protected:
+        std::array<Histogram, static_cast<size_t>(Phase::Count)> Current; // current interval
+        std::array<Histogram, static_cast<size_t>(Phase::Count)> Total;   // since Start()
+
+        std::vector<Report> Reports;
+        Report              TotalReport; // updated with every report
+
+        std::chrono::steady_clock::time_point StartTime;
+        std::chrono::steady_clock::time_point IntervalTime;
+        std::chrono::steady_clock::time_point FrameTime;
+
+    public:
+        void Start();
+        void Finish();
+
+        // Records time elapsed since `since` for given phase
+        // Returns current time, so consecutive phases can be chained
+        std::chrono::steady_clock::time_point Record(Phase phase, const std::chrono::steady_clock::time_point& since);
+
+        // Records Phase::Frame, must be called once at end of every frame
+        // Returns true when interval has been completed, and new report is available
+        bool NextFrame();
+
+        // Returns summary of last completed interval
+        const Summary& GetLast(Phase phase) const;
+        // Returns summary of all completed intervals
+        const Summary& GetTotal(Phase phase) const;
+
+        const std::vector<Report>& GetReports() const;
+
+        bool WriteCSV(const std::string& filename) const;
+        bool WriteJSON(const std::string& filename) const;
+
+        static std::string GetPhaseName(Phase phase);
+        static Summary     GetSummary(const Histogram& histogram);
+
+    protected:
+        // Moves current interval into new report
+        void AddReport();
+    };
+}
@@ -0,0 +1,291 @@
+#include "Scene.hpp"
+
+#include <algorithm>
+#include <cmath> // std::floor
+
+uint32_t EWAN::Scene::Insert(sf::Sprite* sprite, int32_t layer /*= 0 */)
+{
+    if(!sprite)
+        return 0;
+
+    uint32_t index;
+    if(FreeEntries.empty())
+    {
+        index = static_cast<uint32_t>(Entries.size());
+        Entries.emplace_back();
+    }
+    else
+    {
+        index = FreeEntries.back();
+        FreeEntries.pop_back();
+    }
+
+    Entry& entry = Entries[index];
+    entry        = Entry();
+    entry.Sprite = sprite;
+    entry.Bounds = sprite->getGlobalBounds();
+    entry.Layer  = layer;
+    entry.Order  = LastOrder++;
+
+    AddToCells(index);
+    Size++;
+
+    // Zero is reserved for errors
+    return index + 1;
+}
+
+bool EWAN::Scene::Remove(uint32_t id)
+{
+    Entry* entry = GetEntry(id);
+    if(!entry)
+        return false;
+
+    RemoveFromCells(id - 1);
+
+    entry->Sprite = nullptr;
+    FreeEntries.push_back(id - 1);
+    Size--;
+
+    return true;
+}
+
+uint32_t EWAN::Scene::RemoveSprite(const sf::Sprite* sprite)
+{
+    if(!sprite || !Size)
+        return 0;
+
+    uint32_t result = 0;
+
+    for(uint32_t index = 0; index < Entries.size(); index++)
+    {
+        if(Entries[index].Sprite == sprite && Remove(index + 1))
+            result++;
+    }
+
+    return result;
+}
+
+void EWAN::Scene::Clear()
+{
+    Entries.clear();
+    FreeEntries.clear();
+    Cells.clear();
+    QueryResult.clear();
+
+    Size    = 0;
+    Visible = Culled = 0;
+}
+
+uint32_t EWAN::Scene::GetSize() const
+{
+    return Size;
+}
+
+float EWAN::Scene::GetCellSize() const
+{
+    return CellSize;
+}
+
+void EWAN::Scene::SetCellSize(float size)
+{
+    if(size <= 0.0f || size == CellSize)
+        return;
+
+    CellSize = size;
+
+    // Every entry needs to be placed again
+    Cells.clear();
+
+    for(uint32_t index = 0; index < Entries.size(); index++)
+    {
+        if(Entries[index].Sprite)
+        {
+            Entries[index].CellRight = Entries[index].CellBottom = -1;
+            AddToCells(index);
+        }
+    }
+}
+
+bool EWAN::Scene::Update(uint32_t id)
+{
+    Entry* entry = GetEntry(id);
+    if(!entry)
+        return false;
+
+    entry->Bounds = entry->Sprite->getGlobalBounds();
+
+    // Sprites usually move within same cell(s)
+    if(GetCell(entry->Bounds.left) == entry->CellLeft && GetCell(entry->Bounds.top) == entry->CellTop && GetCell(entry->Bounds.left + entry->Bounds.width) == entry->CellRight && GetCell(entry->Bounds.top + entry->Bounds.height) == entry->CellBottom)
+        return true;
+
+    RemoveFromCells(id - 1);
+    AddToCells(id - 1);
+
+    return true;
+}
+
+void EWAN::Scene::UpdateAll()
+{
+    for(uint32_t index = 0; index < Entries.size(); index++)
+    {
+        if(Entries[index].Sprite)
+            Update(index + 1);
+    }
+}
+
+bool EWAN::Scene::SetPosition(uint32_t id, const sf::Vector2f& position)
+{
+    Entry* entry = GetEntry(id);
+    if(!entry)
+        return false;
+
+    entry->Sprite->setPosition(position);
+
+    return Update(id);
+}
+
+uint32_t EWAN::Scene::SetPositions(const uint32_t* ids, const sf::Vector2f* positions, size_t count)
+{
+    uint32_t result = 0;
+
+    for(size_t p = 0; p < count; p++)
+    {
+        if(SetPosition(ids[p], positions[p]))
+            result++;
+    }
+
+    return result;
+}
+
+const std::vector<const EWAN::Scene::Entry*>& EWAN::Scene::Query(const sf::FloatRect& area)
+{
+    QueryResult.clear();
+
+    // Entries covering multiple cells are visited once per query
+    if(++LastQuery == 0)
+    {
+        for(Entry& entry : Entries)
+        {
+            entry.Query = 0;
+        }
+
+        LastQuery = 1;
+    }
+
+    auto visit = [this, &area](const std::vector<uint32_t>& cell) {
+        for(const uint32_t index : cell)
+        {
+            Entry& entry = Entries[index];
+            if(entry.Query == LastQuery)
+                continue;
+
+            entry.Query = LastQuery;
+
+            if(entry.Bounds.intersects(area))
+                QueryResult.push_back(&entry);
+        }
+    };
+
+    const int64_t cellLeft   = GetCell(area.left);
+    const int64_t cellTop    = GetCell(area.top);
+    const int64_t cellRight  = GetCell(area.left + area.width);
+    const int64_t cellBottom = GetCell(area.top + area.height);
+
+    // Zoomed out views can cover more cells than there are in use
+    if((cellRight - cellLeft + 1) * (cellBottom - cellTop + 1) > static_cast<int64_t>(Cells.size()))
+    {
+        for(const auto& cell : Cells)
+        {
+            visit(cell.second);
+        }
+    }
+    else
+    {
+        for(int64_t y = cellTop; y <= cellBottom; y++)
+        {
+            for(int64_t x = cellLeft; x <= cellRight; x++)
+            {
+                auto it = Cells.find(GetCellKey(static_cast<int32_t>(x), static_cast<int32_t>(y)));
+                if(it != Cells.end())
+                    visit(it->second);
+            }
+        }
+    }
+
+    std::sort(QueryResult.begin(), QueryResult.end(), [](const Entry* left, const Entry* right) -> bool {
+        if(left->Layer != right->Layer)
+            return left->Layer < right->Layer;
+
+        return left->Order < right->Order;
+    });
+
+    Visible = static_cast<uint32_t>(QueryResult.size());
+    Culled  = Size - Visible;
+
+    return QueryResult;
+}
+
+//
+
+EWAN::Scene::Entry* EWAN::Scene::GetEntry(uint32_t id)
+{
+    if(!id || id > Entries.size() || !Entries[id - 1].Sprite)
+        return nullptr;
+
+    return &Entries[id - 1];
+}
+
+void EWAN::Scene::AddToCells(uint32_t index)
+{
+    Entry& entry = Entries[index];
+
+    entry.CellLeft   = GetCell(entry.Bounds.left);
+    entry.CellTop    = GetCell(entry.Bounds.top);
+    entry.CellRight  = GetCell(entry.Bounds.left + entry.Bounds.width);
+    entry.CellBottom = GetCell(entry.Bounds.top + entry.Bounds.height);
+
+    for(int32_t y = entry.CellTop; y <= entry.CellBottom; y++)
+    {
+        for(int32_t x = entry.CellLeft; x <= entry.CellRight; x++)
+        {
+            Cells[GetCellKey(x, y)].push_back(index);
+        }
+    }
+}
+
+void EWAN::Scene::RemoveFromCells(uint32_t index)
+{
+    const Entry& entry = Entries[index];
+
+    for(int32_t y = entry.CellTop; y <= entry.CellBottom; y++)
+    {
+        for(int32_t x = entry.CellLeft; x <= entry.CellRight; x++)
+        {
+            auto it = Cells.find(GetCellKey(x, y));
+            if(it == Cells.end())
+                continue;
+
+            // Order within cell doesn't matter, Query() sorts results
+            std::vector<uint32_t>& cell = it->second;
+            auto                   idx  = std::find(cell.begin(), cell.end(), index);
+            if(idx != cell.end())
+            {
+                *idx = cell.back();
+                cell.pop_back();
+            }
+
+            if(cell.empty())
+                Cells.erase(it);
+        }
+    }
+}
+
+int32_t EWAN::Scene::GetCell(float position) const
+{
+    return static_cast<int32_t>(std::floor(position / CellSize));
+}
+
+/* static */ uint64_t EWAN::Scene::GetCellKey(int32_t x, int32_t y)
+{
+    return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Libs/SFML.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace EWAN
+{
+    // Keeps sprites in uniform grid, so only sprites overlapping given area needs to be visited when drawing
+    //
+    // Scene doesn't own sprites; sprites must be removed from scene before they're deleted
+    // App scene removes sprites deleted from Content::Sprite on its own, see RemoveSprite()
+    // Sprites moved outside of scene must be updated with Update()/UpdateAll(), SetPosition() and SetPositions() does that automatically
+    class Scene
+    {
+    public:
+        struct Entry
+        {
+            sf::Sprite*   Sprite = nullptr;
+            sf::FloatRect Bounds;
+            int32_t       Layer = 0;
+            uint32_t      Order = 0; // insertion order, keeps draw order stable within layer
+
+            // Cells range covered by Bounds
+            int32_t CellLeft   = 0;
+            int32_t CellTop    = 0;
+            int32_t CellRight  = -1;
+            int32_t CellBottom = -1;
+
+            uint32_t Query = 0; // last query which visited entry
+        };
+
+    public:
+        // Results of last Query()
+        uint32_t Visible = 0;
+        uint32_t Culled  = 0;
+
+    protected:
+        float CellSize = 256.0f;
+
+        std::vector<Entry>                                  Entries;
+        std::vector<uint32_t>                               FreeEntries;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> Cells; // indexes in Entries
+        std::vector<const Entry*>                           QueryResult;
+
+        uint32_t Size      = 0;
+        uint32_t LastOrder = 0;
+        uint32_t LastQuery = 0;
+
+    public:
+        // Returns entry id, or zero on error
+        uint32_t Insert(sf::Sprite* sprite, int32_t layer = 0);
+        bool     Remove(uint32_t id);
+        void     Clear();
+
+        // Removes all entries using given sprite
+        // Returns amount of removed entries
+        uint32_t RemoveSprite(const sf::Sprite* sprite);
+
+        uint32_t GetSize() const;
+
+        float GetCellSize() const;
+        void  SetCellSize(float size);
+
+        // Re-reads sprite bounds; grid is changed only when sprite moved to other cell(s)
+        bool Update(uint32_t id);
+        void UpdateAll();
+
+        bool     SetPosition(uint32_t id, const sf::Vector2f& position);
+        uint32_t SetPositions(const uint32_t* ids, const sf::Vector2f* positions, size_t count);
+
+        // Returns sprites overlapping given area, sorted by layer and insertion order
+        // Result is valid until next call
+        const std::vector<const Entry*>& Query(const sf::FloatRect& area);
+
+    protected:
+        Entry* GetEntry(uint32_t id);
+
+        void AddToCells(uint32_t index);
+        void RemoveFromCells(uint32_t index);
+
+        int32_t         GetCell(float position) const;
+        static uint64_t GetCellKey(int32_t x, int32_t y);
+    };
+}
@@ -3,10 +3,14 @@
 #include "App.hpp"
 #include "Content.hpp"
 #include "Log.hpp"
+#include "Math.hpp"
+#include "Profiler.hpp"
 #include "Text.hpp"
+#include "Tilemap.hpp"
 
 #include "Libs/SFML.hpp"
 
+#include <new>         // placement new
 #include <type_traits> // std::is_same_v
 
 using namespace std::literals::string_literals;
@@ -19,6 +23,80 @@ namespace
             ok = -1;
     }
 
+    static void WorkerMessageCallback(const as::asSMessageInfo* msg, void*)
+    {
+        EWAN::Script::LogMessage(*msg);
+    }
+
+    static as::CScriptArray* ContentCacheKeys(EWAN::Content::Cache* cache)
+    {
+        as::asIScriptContext* context = as::asGetActiveContext();
+        if(!context)
+            return nullptr;
+
+        as::CScriptArray* result = as::CScriptArray::Create(context->GetEngine()->GetTypeInfoByDecl("array<string>"));
+        EWAN::Script::AppendVectorToArray(cache->Keys(), result, false);
+
+        return result;
+    }
+
+    // Value types are constructed in memory provided by AngelScript
+
+    template<typename T, typename... A>
+    static void ValueConstruct(void* memory, A... args)
+    {
+        new(memory) T(args...);
+    }
+
+    // Arrays of value types keep pointers to separately allocated objects,
+    // points are gathered into contiguous buffer before handing them to Math
+
+    static std::vector<sf::Vector2f> GatherPoints(const as::CScriptArray& points)
+    {
+        std::vector<sf::Vector2f> result(points.GetSize());
+
+        for(as::asUINT p = 0; p < points.GetSize(); p++)
+        {
+            result[p] = *static_cast<const sf::Vector2f*>(points.At(p));
+        }
+
+        return result;
+    }
+
+    static void RectFromPoints(void* memory, const as::CScriptArray& points)
+    {
+        const std::vector<sf::Vector2f> buffer = GatherPoints(points);
+
+        new(memory) sf::FloatRect(EWAN::Math::GetBounds(buffer.data(), buffer.size()));
+    }
+
+    static void TransformPoints(const sf::Transform& transform, as::CScriptArray& points)
+    {
+        std::vector<sf::Vector2f> buffer = GatherPoints(points);
+
+        EWAN::Math::TransformPoints(transform, buffer.data(), buffer.size());
+
+        for(as::asUINT p = 0; p < points.GetSize(); p++)
+        {
+            *static_cast<sf::Vector2f*>(points.At(p)) = buffer[p];
+        }
+    }
+
+    static uint32_t SceneSetPositions(EWAN::Scene& scene, const as::CScriptArray& ids, const as::CScriptArray& positions)
+    {
+        const std::vector<sf::Vector2f> buffer = GatherPoints(positions);
+        const as::asUINT                count  = std::min(ids.GetSize(), positions.GetSize());
+
+        // Arrays of primitives are stored in single buffer
+        return count ? scene.SetPositions(static_cast<const uint32_t*>(ids.At(0)), buffer.data(), count) : 0;
+    }
+
+    static bool TilemapSetTiles(EWAN::Tilemap& tilemap, const as::CScriptArray& tiles)
+    {
+        // Arrays of primitives are stored in single buffer
+        return tilemap.SetTiles(tiles.GetSize() ? static_cast<const uint32_t*>(tiles.At(0)) : nullptr, tiles.GetSize());
+    }
+
     template<typename T>
     std::string TypenameToString()
     {
@@ -44,6 +122,16 @@ namespace
     WriteInfo(context->GetEngine(), text, UserData::Get(context->GetEngine())->Script->GetContextFunctionDetails(context));
 }
 
+/* static */ void EWAN::Script::API::WorkerLog(void*, std::string text)
+{
+    as::asIScriptContext* context = as::asGetActiveContext();
+    if(!context)
+        return;
+
+    as::asIScriptFunction* function = context->GetFunction();
+    WriteInfo(context->GetEngine(), text, "worker "s + function->GetModuleName() + " " + function->GetDeclaration(true, true, false));
+}
+
 /* static */ bool EWAN::Script::API::Init(App* app, as::asIScriptEngine* engine, const std::string& namespace_)
 {
     //
@@ -74,21 +162,32 @@ namespace
 
     static const std::vector<const char*> zeroObjRefNoHandle = {
         "App",
+        "AppTiming",
         "Content",
         "ContentCache", // TODO Replace with ContentFont
         "ContentSprite",
         "ContentTexture",
+        "ContentTilemap",
         "GameInfo",
         "Keyboard",
+        "Profiler",
+        "Scene",
         "Script",
+        "ScriptGarbage",
+        "ScriptMemory",
         "Window",
-        "WindowFPS"
+        "WindowBatch",
+        "WindowFPS",
+        "WindowHud"
         //
     };
 
     static const std::vector<const char*> zeroObjRefNoCount = {
+        "InputBatch",
+        "ScriptStats",
         "Sprite",
-        "Texture"
+        "Texture",
+        "Tilemap"
         //
     };
 
@@ -111,6 +210,19 @@ namespace
         _(ok, engine->RegisterObjectType(obj, 0, as::asOBJ_REF | as::asOBJ_GC | as::asOBJ_TEMPLATE));
     }
 
+    // Value types
+
+    _(ok, engine->RegisterObjectType("Vec2f", sizeof(sf::Vector2f), as::asOBJ_VALUE | as::asOBJ_POD | as::asGetTypeTraits<sf::Vector2f>() | as::asOBJ_APP_CLASS_ALLFLOATS));
+    _(ok, engine->RegisterObjectType("Vec2i", sizeof(sf::Vector2i), as::asOBJ_VALUE | as::asOBJ_POD | as::asGetTypeTraits<sf::Vector2i>() | as::asOBJ_APP_CLASS_ALLINTS));
+    _(ok, engine->RegisterObjectType("Rect", sizeof(sf::FloatRect), as::asOBJ_VALUE | as::asOBJ_POD | as::asGetTypeTraits<sf::FloatRect>() | as::asOBJ_APP_CLASS_ALLFLOATS));
+    _(ok, engine->RegisterObjectType("Transform", sizeof(sf::Transform), as::asOBJ_VALUE | as::asOBJ_POD | as::asGetTypeTraits<sf::Transform>() | as::asOBJ_APP_CLASS_ALLFLOATS));
+    _(ok, engine->RegisterObjectType("ContentId", sizeof(Content::Id), as::asOBJ_VALUE | as::asOBJ_POD | as::asGetTypeTraits<Content::Id>() | as::asOBJ_APP_CLASS_ALLINTS));
+    _(ok, engine->RegisterObjectType("ProfilerSummary", sizeof(Profiler::Summary), as::asOBJ_VALUE | as::asOBJ_POD | as::asGetTypeTraits<Profiler::Summary>()));
+
+    _(ok, RegisterVector<float>(engine, "Vec2f"));
+    _(ok, RegisterVector<int32_t>(engine, "Vec2i"));
+    _(ok, RegisterMath(engine));
+
     // NOTE: Properties and methods marked with 'SFML' are binding directly to SFML
     //       In most cases asMETHODPR() needs to be used instead of asMETHOD()
 
@@ -118,19 +230,77 @@ namespace
     _(ok, engine->RegisterObjectProperty("App", "      bool     Restart", asOFFSET(App, Restart)));
 
     _(ok, engine->RegisterObjectProperty("App", "      Content  Content", asOFFSET(App, Content)));
-    _(ok, engine->RegisterObjectProperty("App", "const GameInfo GameInfo", asOFFSET(App, GameInfo)));
-    _(ok, engine->RegisterObjectProperty("App", "const Keyboard Keyboard", asOFFSET(App, Keyboard)));
-    _(ok, engine->RegisterObjectProperty("App", "const Script   Script", asOFFSET(App, Script)));
+    _(ok, engine->RegisterObjectProperty("App", "const GameInfo  GameInfo", asOFFSET(App, GameInfo)));
+    _(ok, engine->RegisterObjectProperty("App", "const Keyboard  Keyboard", asOFFSET(App, Keyboard)));
+    _(ok, engine->RegisterObjectProperty("App", "const Script    Script", asOFFSET(App, Script)));
     _(ok, engine->RegisterObjectProperty("App", "      Window   Window", asOFFSET(App, Window)));
+    _(ok, engine->RegisterObjectProperty("App", "      AppTiming Timing", asOFFSET(App, Timing)));
+    _(ok, engine->RegisterObjectProperty("App", "      Profiler Profiler", asOFFSET(App, Profiler)));
+    _(ok, engine->RegisterObjectProperty("App", "      Scene    Scene", asOFFSET(App, Scene)));
 
     _(ok, engine->RegisterObjectMethod("App", "void Log(string text) const", as::asFUNCTION(AppLog), as::asCALL_CDECL_OBJFIRST));
 
     //
 
+    _(ok, engine->RegisterObjectProperty("AppTiming", "      float  UpdateStep", asOFFSET(decltype(App::Timing), UpdateStep)));
+    _(ok, engine->RegisterObjectProperty("AppTiming", "const float  Alpha", asOFFSET(decltype(App::Timing), Alpha)));
+    _(ok, engine->RegisterObjectProperty("AppTiming", "      uint32 UpdateMaxSteps", asOFFSET(decltype(App::Timing), UpdateMaxSteps)));
+    _(ok, engine->RegisterObjectProperty("AppTiming", "const uint32 UpdateSteps", asOFFSET(decltype(App::Timing), UpdateSteps)));
+    _(ok, engine->RegisterObjectProperty("AppTiming", "      uint32 FrameLimit", asOFFSET(decltype(App::Timing), FrameLimit)));
+    _(ok, engine->RegisterObjectProperty("AppTiming", "const float  SleepTime", asOFFSET(decltype(App::Timing), SleepTime)));
+    _(ok, engine->RegisterObjectProperty("AppTiming", "      float  SpinTime", asOFFSET(decltype(App::Timing), SpinTime)));
+    _(ok, engine->RegisterObjectProperty("AppTiming", "      float  FixedFrameTime", asOFFSET(decltype(App::Timing), FixedFrameTime)));
+    _(ok, engine->RegisterObjectProperty("AppTiming", "const float  FrameDelta", asOFFSET(decltype(App::Timing), FrameDelta)));
+    _(ok, engine->RegisterObjectProperty("AppTiming", "const double Time", asOFFSET(decltype(App::Timing), Time)));
+    _(ok, engine->RegisterObjectProperty("AppTiming", "const uint32 Frames", asOFFSET(decltype(App::Timing), Frames)));
+
+    //
+
+    _(ok, engine->RegisterEnum("ProfilerPhase"));
+    _(ok, engine->RegisterEnumValue("ProfilerPhase", "Frame", static_cast<int>(Profiler::Phase::Frame)));
+    _(ok, engine->RegisterEnumValue("ProfilerPhase", "Update", static_cast<int>(Profiler::Phase::Update)));
+    _(ok, engine->RegisterEnumValue("ProfilerPhase", "Render", static_cast<int>(Profiler::Phase::Render)));
+    _(ok, engine->RegisterEnumValue("ProfilerPhase", "Maintenance", static_cast<int>(Profiler::Phase::Maintenance)));
+
+    _(ok, engine->RegisterObjectProperty("Profiler", "bool   Enabled", asOFFSET(Profiler, Enabled)));
+    _(ok, engine->RegisterObjectProperty("Profiler", "float  Interval", asOFFSET(Profiler, Interval)));
+    _(ok, engine->RegisterObjectProperty("Profiler", "string OutputCSV", asOFFSET(Profiler, OutputCSV)));
+    _(ok, engine->RegisterObjectProperty("Profiler", "string OutputJSON", asOFFSET(Profiler, OutputJSON)));
+
+    _(ok, engine->RegisterObjectMethod("Profiler", "const ProfilerSummary& Last(ProfilerPhase phase) const", as::asMETHOD(Profiler, GetLast), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Profiler", "const ProfilerSummary& Total(ProfilerPhase phase) const", as::asMETHOD(Profiler, GetTotal), as::asCALL_THISCALL));
+
+    _(ok, engine->RegisterObjectProperty("ProfilerSummary", "const float  P50", asOFFSET(Profiler::Summary, P50)));
+    _(ok, engine->RegisterObjectProperty("ProfilerSummary", "const float  P95", asOFFSET(Profiler::Summary, P95)));
+    _(ok, engine->RegisterObjectProperty("ProfilerSummary", "const float  P99", asOFFSET(Profiler::Summary, P99)));
+    _(ok, engine->RegisterObjectProperty("ProfilerSummary", "const float  Max", asOFFSET(Profiler::Summary, Max)));
+    _(ok, engine->RegisterObjectProperty("ProfilerSummary", "const float  Mean", asOFFSET(Profiler::Summary, Mean)));
+    _(ok, engine->RegisterObjectProperty("ProfilerSummary", "const uint32 Count", asOFFSET(Profiler::Summary, Count)));
+
+    //
+
+    _(ok, engine->RegisterObjectProperty("Scene", "const uint32 Visible", asOFFSET(Scene, Visible)));
+    _(ok, engine->RegisterObjectProperty("Scene", "const uint32 Culled", asOFFSET(Scene, Culled)));
+
+    _(ok, engine->RegisterObjectMethod("Scene", "uint32 get_Size() const property", as::asMETHOD(Scene, GetSize), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Scene", "float  get_CellSize() const property", as::asMETHOD(Scene, GetCellSize), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Scene", "void   set_CellSize(float size) property", as::asMETHOD(Scene, SetCellSize), as::asCALL_THISCALL));
+
+    _(ok, engine->RegisterObjectMethod("Scene", "uint32 Insert(Sprite@ sprite, int32 layer = 0)", as::asMETHOD(Scene, Insert), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Scene", "bool   Remove(uint32 id)", as::asMETHOD(Scene, Remove), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Scene", "void   Clear()", as::asMETHOD(Scene, Clear), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Scene", "bool   Update(uint32 id)", as::asMETHOD(Scene, Update), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Scene", "void   UpdateAll()", as::asMETHOD(Scene, UpdateAll), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Scene", "bool   SetPosition(uint32 id, const Vec2f&in position)", as::asMETHOD(Scene, SetPosition), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Scene", "uint32 SetPositions(const array<uint32>& ids, const array<Vec2f>& positions)", as::asFUNCTION(SceneSetPositions), as::asCALL_CDECL_OBJFIRST));
+
+    //
+
     _(ok, engine->RegisterObjectProperty("Content", "const string   RootDirectory", asOFFSET(Content, RootDirectory)));
     _(ok, engine->RegisterObjectProperty("Content", "ContentCache   Font", asOFFSET(Content, Font)));
     _(ok, engine->RegisterObjectProperty("Content", "ContentSprite  Sprite", asOFFSET(Content, Sprite)));
     _(ok, engine->RegisterObjectProperty("Content", "ContentTexture Texture", asOFFSET(Content, Texture)));
+    _(ok, engine->RegisterObjectProperty("Content", "ContentTilemap Tilemap", asOFFSET(Content, Tilemap)));
 
     _(ok, engine->RegisterObjectMethod("Content", "size_t DeleteAll()", as::asMETHOD(Content, DeleteAll), as::asCALL_THISCALL));
     _(ok, engine->RegisterObjectMethod("Content", "size_t Size()", as::asMETHOD(Content, Size), as::asCALL_THISCALL));
@@ -139,9 +309,21 @@ namespace
 
     //
 
+    // Hashing and interning happens in constructor, which is why ContentId cannot be created from string implicitly
+    _(ok, engine->RegisterObjectBehaviour("ContentId", as::asBEHAVE_CONSTRUCT, "void f()", as::asFUNCTION(ValueConstruct<Content::Id>), as::asCALL_CDECL_OBJFIRST));
+    _(ok, engine->RegisterObjectBehaviour("ContentId", as::asBEHAVE_CONSTRUCT, "void f(const string&in name) explicit", as::asFUNCTION((ValueConstruct<Content::Id, const std::string&>)), as::asCALL_CDECL_OBJFIRST));
+
+    _(ok, engine->RegisterObjectProperty("ContentId", "const uint64 Hash", asOFFSET(Content::Id, Hash)));
+
+    _(ok, engine->RegisterObjectMethod("ContentId", "bool   opEquals(const ContentId&in) const", as::asMETHOD(Content::Id, operator==), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("ContentId", "string get_Name() const property", as::asMETHOD(Content::Id, GetName), as::asCALL_THISCALL));
+
+    //
+
     _(ok, RegisterContentCache(engine, "ContentCache"));
     _(ok, RegisterContentCache(engine, "ContentSprite", "Sprite@"));
     _(ok, RegisterContentCache(engine, "ContentTexture", "Texture@"));
+    _(ok, RegisterContentCache(engine, "ContentTilemap", "Tilemap@"));
 
     //
 
@@ -151,6 +333,26 @@ namespace
 
     //
 
+    _(ok, engine->RegisterEnum("InputType"));
+    _(ok, engine->RegisterEnumValue("InputType", "KeyDown", static_cast<int>(Window::InputBatch::Type::KeyDown)));
+    _(ok, engine->RegisterEnumValue("InputType", "KeyUp", static_cast<int>(Window::InputBatch::Type::KeyUp)));
+    _(ok, engine->RegisterEnumValue("InputType", "MouseDown", static_cast<int>(Window::InputBatch::Type::MouseDown)));
+    _(ok, engine->RegisterEnumValue("InputType", "MouseUp", static_cast<int>(Window::InputBatch::Type::MouseUp)));
+
+    _(ok, engine->RegisterObjectProperty("InputBatch", "const int32  MouseX", asOFFSET(Window::InputBatch, MouseX)));
+    _(ok, engine->RegisterObjectProperty("InputBatch", "const int32  MouseY", asOFFSET(Window::InputBatch, MouseY)));
+    _(ok, engine->RegisterObjectProperty("InputBatch", "const int32  MouseDeltaX", asOFFSET(Window::InputBatch, MouseDeltaX)));
+    _(ok, engine->RegisterObjectProperty("InputBatch", "const int32  MouseDeltaY", asOFFSET(Window::InputBatch, MouseDeltaY)));
+    _(ok, engine->RegisterObjectProperty("InputBatch", "const uint32 MouseMoves", asOFFSET(Window::InputBatch, MouseMoves)));
+
+    _(ok, engine->RegisterObjectMethod("InputBatch", "Vec2i     get_Mouse() const property", as::asMETHOD(Window::InputBatch, GetMouse), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("InputBatch", "Vec2i     get_MouseDelta() const property", as::asMETHOD(Window::InputBatch, GetMouseDelta), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("InputBatch", "uint32    get_Count() const property", as::asMETHOD(Window::InputBatch, GetCount), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("InputBatch", "InputType GetType(uint32 index) const", as::asMETHOD(Window::InputBatch, GetType), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("InputBatch", "int32     GetCode(uint32 index) const", as::asMETHOD(Window::InputBatch, GetCode), as::asCALL_THISCALL));
+
+    //
+
     _(ok, engine->RegisterEnum("Key"));
     _(ok, engine->RegisterEnumValue("Key", "Unknown", sf::Keyboard::Key::Unknown));
     _(ok, engine->RegisterEnumValue("Key", "A", sf::Keyboard::Key::A));
@@ -270,14 +472,66 @@ namespace
 
     //
 
-    _(ok, engine->RegisterObjectProperty("Script", "const string RootDirectory", asOFFSET(Script, RootDirectory)));
+    _(ok, engine->RegisterObjectProperty("Script", "const string        RootDirectory", asOFFSET(Script, RootDirectory)));
+    _(ok, engine->RegisterObjectProperty("Script", "const ScriptGarbage Garbage", asOFFSET(Script, Garbage)));
+    _(ok, engine->RegisterObjectProperty("Script", "const ScriptMemory  Memory", asOFFSET(Script, MemoryStats)));
 
     _(ok, engine->RegisterObjectMethod("Script", "string get_CurrentEventName() const property", as::asMETHOD(Script, CurrentEventName_ScriptCall), as::asCALL_THISCALL));
 
     _(ok, engine->RegisterObjectMethod("Script", "bool LoadModule(string&in fileName, string&in moduleName) const", as::asMETHOD(Script, LoadModule_ScriptCall), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Script", "bool LoadModuleAsync(string&in fileName, string&in moduleName) const", as::asMETHOD(Script, LoadModuleAsync_ScriptCall), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Script", "void LoadLazy(string&in moduleName) const", as::asMETHOD(Script, LoadLazy_ScriptCall), as::asCALL_THISCALL));
     _(ok, engine->RegisterObjectMethod("Script", "bool UnloadModule(string&in moduleName) const", as::asMETHOD(Script, UnloadModule_ScriptCall), as::asCALL_THISCALL));
     _(ok, engine->RegisterObjectMethod("Script", "void Yield() const", as::asMETHOD(Script, Yield_ScriptCall), as::asCALL_THISCALL));
 
+    _(ok, engine->RegisterObjectMethod("Script", "void  Reload() const", as::asMETHOD(Script, Reload_ScriptCall), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Script", "float get_ReloadInterval() const property", as::asMETHOD(Script, GetReloadInterval_ScriptCall), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Script", "void  set_ReloadInterval(float interval) const property", as::asMETHOD(Script, SetReloadInterval_ScriptCall), as::asCALL_THISCALL));
+
+    _(ok, engine->RegisterObjectMethod("Script", "uint32 Spawn(string&in fileName, string&in function, string&in data) const", as::asMETHOD(Script, Spawn_ScriptCall), as::asCALL_THISCALL));
+
+    _(ok, engine->RegisterObjectMethod("Script", "ScriptStats@ GetStats(string&in moduleName, string&in functionDeclaration) const", as::asMETHOD(Script, GetStats_ScriptCall), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Script", "float get_StatsInterval() const property", as::asMETHOD(Script, GetStatsInterval_ScriptCall), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Script", "void  set_StatsInterval(float interval) const property", as::asMETHOD(Script, SetStatsInterval_ScriptCall), as::asCALL_THISCALL));
+
+    _(ok, engine->RegisterObjectMethod("Script", "bool get_DebugContexts() const property", as::asMETHOD(Script, GetDebugContexts_ScriptCall), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Script", "void set_DebugContexts(bool enabled) const property", as::asMETHOD(Script, SetDebugContexts_ScriptCall), as::asCALL_THISCALL));
+
+    _(ok, engine->RegisterObjectMethod("Script", "uint32 get_GarbageBudget() const property", as::asMETHOD(Script, GetGarbageBudget_ScriptCall), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Script", "void   set_GarbageBudget(uint32 budget) const property", as::asMETHOD(Script, SetGarbageBudget_ScriptCall), as::asCALL_THISCALL));
+
+    //
+
+    _(ok, engine->RegisterObjectProperty("ScriptGarbage", "const uint32 Alive", asOFFSET(Script::GarbageStats, Alive)));
+    _(ok, engine->RegisterObjectProperty("ScriptGarbage", "const uint32 Destroyed", asOFFSET(Script::GarbageStats, Destroyed)));
+    _(ok, engine->RegisterObjectProperty("ScriptGarbage", "const uint32 Detected", asOFFSET(Script::GarbageStats, Detected)));
+    _(ok, engine->RegisterObjectProperty("ScriptGarbage", "const uint32 FrameSteps", asOFFSET(Script::GarbageStats, FrameSteps)));
+    _(ok, engine->RegisterObjectProperty("ScriptGarbage", "const int64  FrameTime", asOFFSET(Script::GarbageStats, FrameTime)));
+    _(ok, engine->RegisterObjectProperty("ScriptGarbage", "const int64  TimeTotal", asOFFSET(Script::GarbageStats, TimeTotal)));
+    _(ok, engine->RegisterObjectProperty("ScriptGarbage", "const int64  TimeMax", asOFFSET(Script::GarbageStats, TimeMax)));
+
+    //
+
+    _(ok, engine->RegisterObjectProperty("ScriptMemory", "const uint64 Allocations", asOFFSET(Script::Memory::Stats, Allocations)));
+    _(ok, engine->RegisterObjectProperty("ScriptMemory", "const uint64 Frees", asOFFSET(Script::Memory::Stats, Frees)));
+    _(ok, engine->RegisterObjectProperty("ScriptMemory", "const uint64 Bytes", asOFFSET(Script::Memory::Stats, Bytes)));
+    _(ok, engine->RegisterObjectProperty("ScriptMemory", "const uint64 PoolBytes", asOFFSET(Script::Memory::Stats, PoolBytes)));
+    _(ok, engine->RegisterObjectProperty("ScriptMemory", "const uint32 FrameAllocations", asOFFSET(Script::Memory::Stats, FrameAllocations)));
+    _(ok, engine->RegisterObjectProperty("ScriptMemory", "const uint32 FrameFrees", asOFFSET(Script::Memory::Stats, FrameFrees)));
+    _(ok, engine->RegisterObjectProperty("ScriptMemory", "const uint64 FrameBytes", asOFFSET(Script::Memory::Stats, FrameBytes)));
+
+    //
+
+    _(ok, engine->RegisterObjectProperty("ScriptStats", "const uint32 Calls", asOFFSET(UserData::FunctionStats, Calls)));
+    _(ok, engine->RegisterObjectProperty("ScriptStats", "const uint32 Yields", asOFFSET(UserData::FunctionStats, Yields)));
+    _(ok, engine->RegisterObjectProperty("ScriptStats", "const int64  TimeTotal", asOFFSET(UserData::FunctionStats, TimeTotal)));
+    _(ok, engine->RegisterObjectProperty("ScriptStats", "const int64  TimeMax", asOFFSET(UserData::FunctionStats, TimeMax)));
+
+    _(ok, engine->RegisterObjectMethod("ScriptStats", "int64 get_TimeMean() const property", as::asMETHOD(UserData::FunctionStats, GetTimeMean), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("ScriptStats", "int64 get_TimeP99() const property", as::asMETHOD(UserData::FunctionStats, GetTimeP99), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("ScriptStats", "int64 GetTimePercentile(uint8 percentile) const", as::asMETHOD(UserData::FunctionStats, GetTimePercentile), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("ScriptStats", "void  Reset()", as::asMETHOD(UserData::FunctionStats, Reset), as::asCALL_THISCALL));
+
     //
 
     _(ok, engine->RegisterObjectMethod("Sprite", "void Move(float xOffset, float yOffset)", as::asMETHODPR(sf::Sprite, move, (float, float), void), as::asCALL_THISCALL));         // SFML Transformable
@@ -285,7 +539,36 @@ namespace
     _(ok, engine->RegisterObjectMethod("Sprite", "void SetPosition(float x, float y)", as::asMETHODPR(sf::Sprite, setPosition, (float, float), void), as::asCALL_THISCALL));       // SFML Transformable
     _(ok, engine->RegisterObjectMethod("Sprite", "void SetRotation(float angle)", as::asMETHODPR(sf::Sprite, setRotation, (float), void), as::asCALL_THISCALL));                   // SFML Transformable
     _(ok, engine->RegisterObjectMethod("Sprite", "void SetScale(float factorX, float factorY)", as::asMETHODPR(sf::Sprite, setScale, (float, float), void), as::asCALL_THISCALL)); // SFML Transformable
-    _(ok, engine->RegisterObjectMethod("Sprite", "bool SetTexture(const Texture& texture, bool resetRect = true)", as::asMETHOD(sf::Sprite, setTexture), as::asCALL_THISCALL));    // SFML Sprite
+    _(ok, engine->RegisterObjectMethod("Sprite", "bool SetTexture(const Texture& texture, bool resetRect = true)", as::asMETHOD(Content, SetSpriteTexture), as::asCALL_THISCALL_OBJFIRST, &app->Content)); // SFML Sprite, aware of headless placeholders
+
+    _(ok, engine->RegisterObjectMethod("Sprite", "void Move(const Vec2f&in offset)", as::asMETHODPR(sf::Sprite, move, (const sf::Vector2f&), void), as::asCALL_THISCALL));                 // SFML Transformable
+    _(ok, engine->RegisterObjectMethod("Sprite", "void SetOrigin(const Vec2f&in origin)", as::asMETHODPR(sf::Sprite, setOrigin, (const sf::Vector2f&), void), as::asCALL_THISCALL));       // SFML Transformable
+    _(ok, engine->RegisterObjectMethod("Sprite", "void SetPosition(const Vec2f&in position)", as::asMETHODPR(sf::Sprite, setPosition, (const sf::Vector2f&), void), as::asCALL_THISCALL)); // SFML Transformable
+    _(ok, engine->RegisterObjectMethod("Sprite", "void SetScale(const Vec2f&in factors)", as::asMETHODPR(sf::Sprite, setScale, (const sf::Vector2f&), void), as::asCALL_THISCALL));        // SFML Transformable
+
+    _(ok, engine->RegisterObjectMethod("Sprite", "const Vec2f&     get_Origin() const property", as::asMETHOD(sf::Sprite, getOrigin), as::asCALL_THISCALL));             // SFML Transformable
+    _(ok, engine->RegisterObjectMethod("Sprite", "const Vec2f&     get_Position() const property", as::asMETHOD(sf::Sprite, getPosition), as::asCALL_THISCALL));         // SFML Transformable
+    _(ok, engine->RegisterObjectMethod("Sprite", "float            get_Rotation() const property", as::asMETHOD(sf::Sprite, getRotation), as::asCALL_THISCALL));         // SFML Transformable
+    _(ok, engine->RegisterObjectMethod("Sprite", "const Vec2f&     get_Scale() const property", as::asMETHOD(sf::Sprite, getScale), as::asCALL_THISCALL));               // SFML Transformable
+    _(ok, engine->RegisterObjectMethod("Sprite", "const Transform& get_Transform() const property", as::asMETHOD(sf::Sprite, getTransform), as::asCALL_THISCALL));       // SFML Transformable
+    _(ok, engine->RegisterObjectMethod("Sprite", "Rect             get_GlobalBounds() const property", as::asMETHOD(sf::Sprite, getGlobalBounds), as::asCALL_THISCALL)); // SFML Sprite
+    _(ok, engine->RegisterObjectMethod("Sprite", "Rect             get_LocalBounds() const property", as::asMETHOD(sf::Sprite, getLocalBounds), as::asCALL_THISCALL));   // SFML Sprite
+
+    //
+
+    _(ok, engine->RegisterObjectProperty("Tilemap", "      Vec2f  Position", asOFFSET(Tilemap, Position)));
+    _(ok, engine->RegisterObjectProperty("Tilemap", "const uint32 Visible", asOFFSET(Tilemap, Visible)));
+    _(ok, engine->RegisterObjectProperty("Tilemap", "const uint32 Culled", asOFFSET(Tilemap, Culled)));
+    _(ok, engine->RegisterObjectProperty("Tilemap", "const uint32 Rebuilds", asOFFSET(Tilemap, Rebuilds)));
+
+    _(ok, engine->RegisterObjectMethod("Tilemap", "bool   Create(uint32 width, uint32 height, uint32 tileWidth, uint32 tileHeight)", as::asMETHOD(Tilemap, Create), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Tilemap", "bool   SetAtlas(const Content&in content, string&in textureId)", as::asMETHODPR(Tilemap, SetAtlas, (const Content&, const std::string&), bool), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Tilemap", "bool   SetAtlas(const Content&in content, const ContentId&in textureId)", as::asMETHODPR(Tilemap, SetAtlas, (const Content&, const Content::Id&), bool), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Tilemap", "uint32 get_Width() const property", as::asMETHOD(Tilemap, GetWidth), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Tilemap", "uint32 get_Height() const property", as::asMETHOD(Tilemap, GetHeight), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Tilemap", "uint32 GetTile(uint32 x, uint32 y) const", as::asMETHOD(Tilemap, GetTile), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Tilemap", "bool   SetTile(uint32 x, uint32 y, uint32 tile)", as::asMETHOD(Tilemap, SetTile), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Tilemap", "bool   SetTiles(const array<uint32>& tiles)", as::asFUNCTION(TilemapSetTiles), as::asCALL_CDECL_OBJFIRST));
 
     //
 
@@ -297,14 +580,45 @@ namespace
     _(ok, engine->RegisterEnumValue("WindowStyle", "Fullscreen", sf::Style::Fullscreen));
     _(ok, engine->RegisterEnumValue("WindowStyle", "Default", sf::Style::Default));
 
-    _(ok, engine->RegisterObjectProperty("Window", "WindowFPS FPS", asOFFSET(Window, FPS)));
-
-    _(ok, engine->RegisterObjectMethod("Window", "bool get_IsOpen() property", as::asMETHOD(Window, isOpen), as::asCALL_THISCALL)); // SFML
+    _(ok, engine->RegisterObjectProperty("Window", "WindowFPS   FPS", asOFFSET(Window, FPS)));
+    _(ok, engine->RegisterObjectProperty("Window", "WindowHud   Hud", asOFFSET(Window, Hud)));
+    _(ok, engine->RegisterObjectProperty("Window", "bool        InputBatching", asOFFSET(Window, InputBatching)));
+    _(ok, engine->RegisterObjectProperty("Window", "bool        Batching", asOFFSET(Window, Batching)));
+    _(ok, engine->RegisterObjectProperty("Window", "WindowBatch Batch", asOFFSET(Window, Batch)));
+    _(ok, engine->RegisterObjectProperty("Window", "const bool  Headless", asOFFSET(Window, Headless)));
+
+    _(ok, engine->RegisterObjectMethod("Window", "bool get_IsOpen() const property", as::asMETHOD(Window, IsOpen), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "bool get_VSync() const property", as::asMETHOD(Window, GetVSync), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "void set_VSync(bool enabled) property", as::asMETHOD(Window, SetVSync), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "bool get_Pipelining() const property", as::asMETHOD(Window, GetPipelining), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "void set_Pipelining(bool enabled) property", as::asMETHOD(Window, SetPipelining), as::asCALL_THISCALL));
+
+    _(ok, engine->RegisterObjectMethod("Window", "bool   AddLayer(const string&in name, int32 order = 0)", as::asMETHOD(Window, AddLayer), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "bool   RemoveLayer(const string&in name)", as::asMETHOD(Window, RemoveLayer), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "bool   InvalidateLayer(const string&in name)", as::asMETHOD(Window, InvalidateLayer), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "void   InvalidateAllLayers()", as::asMETHOD(Window, InvalidateAllLayers), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "bool   SetLayerVisible(const string&in name, bool visible)", as::asMETHOD(Window, SetLayerVisible), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "uint32 GetLayerInvalidations(const string&in name) const", as::asMETHOD(Window, GetLayerInvalidations), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "uint32 GetLayerRedraws(const string&in name) const", as::asMETHOD(Window, GetLayerRedraws), as::asCALL_THISCALL));
 
     _(ok, engine->RegisterObjectMethod("Window", "void Open(uint32 width = 0, uint32 height = 0, uint8 bitsPerPixel = 32, string&in title = \"\", uint32 style = WindowStyle::Default)", as::asMETHOD(Window, Open), as::asCALL_THISCALL));
-    _(ok, engine->RegisterObjectMethod("Window", "void Close()", as::asMETHOD(Window, close), as::asCALL_THISCALL)); // SFML
+    _(ok, engine->RegisterObjectMethod("Window", "void Close()", as::asMETHOD(Window, Close), as::asCALL_THISCALL));
     _(ok, engine->RegisterObjectMethod("Window", "bool Draw(Sprite@ sprite)", as::asMETHODPR(Window, Draw, (sf::Sprite*), bool), as::asCALL_THISCALL));
     _(ok, engine->RegisterObjectMethod("Window", "bool Draw(const Content&in content, string&in spriteId)", as::asMETHODPR(Window, Draw, (const Content&, const std::string&), bool), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "bool Draw(const Content&in content, const ContentId&in spriteId)", as::asMETHODPR(Window, Draw, (const Content&, const Content::Id&), bool), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "uint32 DrawScene(Scene& scene)", as::asMETHOD(Window, DrawScene), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "uint32 DrawTilemap(Tilemap@ tilemap)", as::asMETHOD(Window, DrawTilemap), as::asCALL_THISCALL));
+
+    _(ok, engine->RegisterObjectMethod("Window", "Vec2i get_MousePosition() const property", as::asMETHOD(Window, GetMousePosition), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("Window", "Vec2f MapPixelToCoords(const Vec2i&in point) const", as::asMETHODPR(Window, mapPixelToCoords, (const sf::Vector2i&) const, sf::Vector2f), as::asCALL_THISCALL)); // SFML RenderTarget
+    _(ok, engine->RegisterObjectMethod("Window", "Vec2i MapCoordsToPixel(const Vec2f&in point) const", as::asMETHODPR(Window, mapCoordsToPixel, (const sf::Vector2f&) const, sf::Vector2i), as::asCALL_THISCALL)); // SFML RenderTarget
+
+    //
+
+    _(ok, engine->RegisterObjectProperty("WindowBatch", "      int32  Layer", asOFFSET(Batch, Layer)));
+    _(ok, engine->RegisterObjectProperty("WindowBatch", "const uint32 Sprites", asOFFSET(Batch, Sprites)));
+    _(ok, engine->RegisterObjectProperty("WindowBatch", "const uint32 DrawCalls", asOFFSET(Batch, DrawCalls)));
+    _(ok, engine->RegisterObjectProperty("WindowBatch", "const uint32 Vertices", asOFFSET(Batch, Vertices)));
 
     //
 
@@ -317,6 +631,21 @@ namespace
 
     //
 
+    _(ok, engine->RegisterEnum("HudPanel"));
+    _(ok, engine->RegisterEnumValue("HudPanel", "FPS", static_cast<int>(Hud::PanelType::FPS)));
+    _(ok, engine->RegisterEnumValue("HudPanel", "Profiler", static_cast<int>(Hud::PanelType::Profiler)));
+    _(ok, engine->RegisterEnumValue("HudPanel", "Content", static_cast<int>(Hud::PanelType::Content)));
+    _(ok, engine->RegisterEnumValue("HudPanel", "Script", static_cast<int>(Hud::PanelType::Script)));
+
+    _(ok, engine->RegisterObjectProperty("WindowHud", "      bool  GraphVisible", asOFFSET(Hud, GraphVisible)));
+    _(ok, engine->RegisterObjectProperty("WindowHud", "const float UpdateTime", asOFFSET(Hud, UpdateTime)));
+    _(ok, engine->RegisterObjectProperty("WindowHud", "const float PrepareTime", asOFFSET(Hud, PrepareTime)));
+
+    _(ok, engine->RegisterObjectMethod("WindowHud", "bool GetVisible(HudPanel panel) const", as::asMETHOD(Hud, GetVisible), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod("WindowHud", "void SetVisible(HudPanel panel, bool visible)", as::asMETHOD(Hud, SetVisible), as::asCALL_THISCALL));
+
+    //
+
     _(ok, engine->SetDefaultNamespace(""));
 
     _(ok, engine->RegisterGlobalProperty(Text::Replace("?::App App", "?", namespace_).c_str(), app));
@@ -337,8 +666,125 @@ namespace
     return context->SetLineCallback(as::asMETHOD(Script, CallbackContextLine), script, as::asCALL_THISCALL) >= 0;
 }
 
+/* static */ bool EWAN::Script::API::InitWorker(as::asIScriptEngine* engine, const std::string& namespace_)
+{
+    //
+    // Worker engines are using separate, minimal API
+    // Anything which could access main thread state (App, Content, Window, ...) must never be registered here
+    //
+
+    int ok = 0;
+
+    // Dummy object, only address is used
+    static uint8_t worker = 0;
+
+    _(ok, engine->SetMessageCallback(as::asFUNCTION(WorkerMessageCallback), nullptr, as::asCALL_CDECL));
+
+    RegisterScriptArray(engine, true);
+    RegisterStdString(engine);
+    RegisterStdStringUtils(engine);
+
+    _(ok, engine->SetDefaultNamespace(namespace_.c_str()));
+
+    _(ok, engine->RegisterObjectType("Worker", 0, as::asOBJ_REF | as::asOBJ_NOHANDLE));
+    _(ok, engine->RegisterObjectMethod("Worker", "void Log(string text) const", as::asFUNCTION(WorkerLog), as::asCALL_CDECL_OBJFIRST));
+
+    _(ok, engine->SetDefaultNamespace(""));
+
+    _(ok, engine->RegisterGlobalProperty(Text::Replace("?::Worker Worker", "?", namespace_).c_str(), &worker));
+
+    return ok >= 0;
+}
+
 //
 
+/* static */ int EWAN::Script::API::RegisterMath(as::asIScriptEngine* engine)
+{
+    int ok = 0;
+
+    _(ok, engine->RegisterObjectProperty("Rect", "float Left", asOFFSET(sf::FloatRect, left)));
+    _(ok, engine->RegisterObjectProperty("Rect", "float Top", asOFFSET(sf::FloatRect, top)));
+    _(ok, engine->RegisterObjectProperty("Rect", "float Width", asOFFSET(sf::FloatRect, width)));
+    _(ok, engine->RegisterObjectProperty("Rect", "float Height", asOFFSET(sf::FloatRect, height)));
+
+    _(ok, engine->RegisterObjectBehaviour("Rect", as::asBEHAVE_CONSTRUCT, "void f()", as::asFUNCTION(ValueConstruct<sf::FloatRect>), as::asCALL_CDECL_OBJFIRST));
+    _(ok, engine->RegisterObjectBehaviour("Rect", as::asBEHAVE_CONSTRUCT, "void f(float left, float top, float width, float height)", as::asFUNCTION((ValueConstruct<sf::FloatRect, float, float, float, float>)), as::asCALL_CDECL_OBJFIRST));
+    _(ok, engine->RegisterObjectBehaviour("Rect", as::asBEHAVE_CONSTRUCT, "void f(const Vec2f&in position, const Vec2f&in size)", as::asFUNCTION((ValueConstruct<sf::FloatRect, const sf::Vector2f&, const sf::Vector2f&>)), as::asCALL_CDECL_OBJFIRST));
+    _(ok, engine->RegisterObjectBehaviour("Rect", as::asBEHAVE_CONSTRUCT, "void f(const array<Vec2f>& points) explicit", as::asFUNCTION(RectFromPoints), as::asCALL_CDECL_OBJFIRST));
+
+    _(ok, engine->RegisterObjectMethod("Rect", "bool opEquals(const Rect&in) const", as::asFUNCTIONPR(sf::operator==, (const sf::FloatRect&, const sf::FloatRect&), bool), as::asCALL_CDECL_OBJFIRST));                                  // SFML
+    _(ok, engine->RegisterObjectMethod("Rect", "bool Contains(const Vec2f&in point) const", as::asMETHODPR(sf::FloatRect, contains, (const sf::Vector2f&) const, bool), as::asCALL_THISCALL));                                           // SFML
+    _(ok, engine->RegisterObjectMethod("Rect", "bool Intersects(const Rect&in rect) const", as::asMETHODPR(sf::FloatRect, intersects, (const sf::FloatRect&) const, bool), as::asCALL_THISCALL));                                        // SFML
+    _(ok, engine->RegisterObjectMethod("Rect", "bool Intersects(const Rect&in rect, Rect&out intersection) const", as::asMETHODPR(sf::FloatRect, intersects, (const sf::FloatRect&, sf::FloatRect&) const, bool), as::asCALL_THISCALL)); // SFML
+
+    //
+
+    _(ok, engine->RegisterObjectBehaviour("Transform", as::asBEHAVE_CONSTRUCT, "void f()", as::asFUNCTION(ValueConstruct<sf::Transform>), as::asCALL_CDECL_OBJFIRST));
+
+    _(ok, engine->RegisterObjectMethod("Transform", "Transform  opMul(const Transform&in) const", as::asFUNCTIONPR(sf::operator*, (const sf::Transform&, const sf::Transform&), sf::Transform), as::asCALL_CDECL_OBJFIRST)); // SFML
+    _(ok, engine->RegisterObjectMethod("Transform", "Vec2f      opMul(const Vec2f&in) const", as::asFUNCTIONPR(sf::operator*, (const sf::Transform&, const sf::Vector2f&), sf::Vector2f), as::asCALL_CDECL_OBJFIRST));       // SFML
+    _(ok, engine->RegisterObjectMethod("Transform", "Transform& opMulAssign(const Transform&in)", as::asFUNCTIONPR(sf::operator*=, (sf::Transform&, const sf::Transform&), sf::Transform&), as::asCALL_CDECL_OBJFIRST));     // SFML
+
+    _(ok, engine->RegisterObjectMethod("Transform", "Transform  get_Inverse() const property", as::asMETHOD(sf::Transform, getInverse), as::asCALL_THISCALL));                                             // SFML
+    _(ok, engine->RegisterObjectMethod("Transform", "Transform& Combine(const Transform&in transform)", as::asMETHOD(sf::Transform, combine), as::asCALL_THISCALL));                                       // SFML
+    _(ok, engine->RegisterObjectMethod("Transform", "Transform& Translate(const Vec2f&in offset)", as::asMETHODPR(sf::Transform, translate, (const sf::Vector2f&), sf::Transform&), as::asCALL_THISCALL)); // SFML
+    _(ok, engine->RegisterObjectMethod("Transform", "Transform& Rotate(float angle)", as::asMETHODPR(sf::Transform, rotate, (float), sf::Transform&), as::asCALL_THISCALL));                               // SFML
+    _(ok, engine->RegisterObjectMethod("Transform", "Transform& Scale(const Vec2f&in factors)", as::asMETHODPR(sf::Transform, scale, (const sf::Vector2f&), sf::Transform&), as::asCALL_THISCALL));        // SFML
+
+    _(ok, engine->RegisterObjectMethod("Transform", "Vec2f TransformPoint(const Vec2f&in point) const", as::asMETHODPR(sf::Transform, transformPoint, (const sf::Vector2f&) const, sf::Vector2f), as::asCALL_THISCALL)); // SFML
+    _(ok, engine->RegisterObjectMethod("Transform", "Rect  TransformRect(const Rect&in rect) const", as::asMETHOD(sf::Transform, transformRect), as::asCALL_THISCALL));                                                  // SFML
+    _(ok, engine->RegisterObjectMethod("Transform", "void  TransformPoints(array<Vec2f>& points) const", as::asFUNCTION(TransformPoints), as::asCALL_CDECL_OBJFIRST));
+
+    return ok;
+}
+
+template<typename T>
+/* static */ int EWAN::Script::API::RegisterVector(as::asIScriptEngine* engine, const std::string& type)
+{
+    using Vector = sf::Vector2<T>;
+
+    int ok = 0;
+
+    // "$" is replaced with vector type, "#" with element type
+    const std::string scalar = TypenameToString<T>();
+    const auto        decl   = [&type, &scalar](const std::string& text) -> std::string {
+        return Text::Replace(Text::Replace(text, "$", type), "#", scalar);
+    };
+
+    _(ok, engine->RegisterObjectProperty(type.c_str(), decl("# X").c_str(), asOFFSET(Vector, x)));
+    _(ok, engine->RegisterObjectProperty(type.c_str(), decl("# Y").c_str(), asOFFSET(Vector, y)));
+
+    _(ok, engine->RegisterObjectBehaviour(type.c_str(), as::asBEHAVE_CONSTRUCT, "void f()", as::asFUNCTION(ValueConstruct<Vector>), as::asCALL_CDECL_OBJFIRST));
+    _(ok, engine->RegisterObjectBehaviour(type.c_str(), as::asBEHAVE_CONSTRUCT, decl("void f(# x, # y)").c_str(), as::asFUNCTION((ValueConstruct<Vector, T, T>)), as::asCALL_CDECL_OBJFIRST));
+
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("bool opEquals(const $&in) const").c_str(), as::asFUNCTIONPR(sf::operator==, (const Vector&, const Vector&), bool), as::asCALL_CDECL_OBJFIRST)); // SFML
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("$    opNeg() const").c_str(), as::asFUNCTIONPR(sf::operator-, (const Vector&), Vector), as::asCALL_CDECL_OBJFIRST));                            // SFML
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("$    opAdd(const $&in) const").c_str(), as::asFUNCTIONPR(sf::operator+, (const Vector&, const Vector&), Vector), as::asCALL_CDECL_OBJFIRST));   // SFML
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("$    opSub(const $&in) const").c_str(), as::asFUNCTIONPR(sf::operator-, (const Vector&, const Vector&), Vector), as::asCALL_CDECL_OBJFIRST));   // SFML
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("$    opMul(#) const").c_str(), as::asFUNCTIONPR(sf::operator*, (const Vector&, T), Vector), as::asCALL_CDECL_OBJFIRST));                        // SFML
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("$    opMul_r(#) const").c_str(), as::asFUNCTIONPR(sf::operator*, (T, const Vector&), Vector), as::asCALL_CDECL_OBJLAST));                       // SFML
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("$    opDiv(#) const").c_str(), as::asFUNCTIONPR(sf::operator/, (const Vector&, T), Vector), as::asCALL_CDECL_OBJFIRST));                        // SFML
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("$&   opAddAssign(const $&in)").c_str(), as::asFUNCTIONPR(sf::operator+=, (Vector&, const Vector&), Vector&), as::asCALL_CDECL_OBJFIRST));       // SFML
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("$&   opSubAssign(const $&in)").c_str(), as::asFUNCTIONPR(sf::operator-=, (Vector&, const Vector&), Vector&), as::asCALL_CDECL_OBJFIRST));       // SFML
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("$&   opMulAssign(#)").c_str(), as::asFUNCTIONPR(sf::operator*=, (Vector&, T), Vector&), as::asCALL_CDECL_OBJFIRST));                            // SFML
+    _(ok, engine->RegisterObjectMethod(type.c_str(), decl("$&   opDivAssign(#)").c_str(), as::asFUNCTIONPR(sf::operator/=, (Vector&, T), Vector&), as::asCALL_CDECL_OBJFIRST));                            // SFML
+
+    // Conversion between float and integer vectors must be explicit, same as in SFML
+    if constexpr(std::is_same_v<T, float>)
+    {
+        _(ok, engine->RegisterObjectBehaviour(type.c_str(), as::asBEHAVE_CONSTRUCT, "void f(const Vec2i&in vector) explicit", as::asFUNCTION((ValueConstruct<Vector, const sf::Vector2i&>)), as::asCALL_CDECL_OBJFIRST));
+
+        _(ok, engine->RegisterObjectMethod(type.c_str(), "float get_Length() const property", as::asFUNCTION(Math::Length), as::asCALL_CDECL_OBJFIRST));
+        _(ok, engine->RegisterObjectMethod(type.c_str(), "float Dot(const Vec2f&in vector) const", as::asFUNCTION(Math::Dot), as::asCALL_CDECL_OBJFIRST));
+    }
+    else
+    {
+        _(ok, engine->RegisterObjectBehaviour(type.c_str(), as::asBEHAVE_CONSTRUCT, "void f(const Vec2f&in vector) explicit", as::asFUNCTION((ValueConstruct<Vector, const sf::Vector2f&>)), as::asCALL_CDECL_OBJFIRST));
+    }
+
+    return ok;
+}
+
 /* static */ int EWAN::Script::API::RegisterContentCache(as::asIScriptEngine* engine, const std::string& type, const std::string& subtype /*= {} */)
 {
     int ok = 0;
@@ -347,16 +793,22 @@ namespace
 
     // Generic cache returns bool when creating new object
     // Custom cache returns newly created subtype
-    _(ok, engine->RegisterObjectMethod(type.c_str(), (boolOrSubtype + " New(string&in id)").c_str(), as::asMETHOD(Content::Cache, New), as::asCALL_THISCALL));
-    _(ok, engine->RegisterObjectMethod(type.c_str(), "bool   Delete(string&in id)", as::asMETHOD(Content::Cache, Delete), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod(type.c_str(), (boolOrSubtype + " New(string&in id)").c_str(), as::asMETHODPR(Content::Cache, New, (const std::string&), void*), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod(type.c_str(), (boolOrSubtype + " New(const ContentId&in id)").c_str(), as::asMETHODPR(Content::Cache, New, (const Content::Id&), void*), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod(type.c_str(), "bool   Delete(string&in id)", as::asMETHODPR(Content::Cache, Delete, (const std::string&), bool), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod(type.c_str(), "bool   Delete(const ContentId&in id)", as::asMETHODPR(Content::Cache, Delete, (const Content::Id&), bool), as::asCALL_THISCALL));
     _(ok, engine->RegisterObjectMethod(type.c_str(), "size_t DeleteAll()", as::asMETHOD(Content::Cache, DeleteAll), as::asCALL_THISCALL));
     _(ok, engine->RegisterObjectMethod(type.c_str(), "size_t Size()", as::asMETHOD(Content::Cache, Size), as::asCALL_THISCALL));
-    _(ok, engine->RegisterObjectMethod(type.c_str(), "bool   Exists(string&in id)", as::asMETHOD(Content::Cache, Exists), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod(type.c_str(), "bool   Exists(string&in id)", as::asMETHODPR(Content::Cache, Exists, (const std::string&) const, bool), as::asCALL_THISCALL));
+    _(ok, engine->RegisterObjectMethod(type.c_str(), "bool   Exists(const ContentId&in id)", as::asMETHODPR(Content::Cache, Exists, (const Content::Id&) const, bool), as::asCALL_THISCALL));
+
+    _(ok, engine->RegisterObjectMethod(type.c_str(), "array<string>@ Keys()", as::asFUNCTION(ContentCacheKeys), as::asCALL_CDECL_OBJFIRST));
 
     // Custom cache can return subtype directly
     if(!subtype.empty())
     {
-        _(ok, engine->RegisterObjectMethod(type.c_str(), (subtype + " Get(string&in id, bool silent = true)").c_str(), as::asMETHOD(Content::Cache, Get), as::asCALL_THISCALL));
+        _(ok, engine->RegisterObjectMethod(type.c_str(), (subtype + " Get(string&in id, bool silent = true)").c_str(), as::asMETHODPR(Content::Cache, Get, (const std::string&, bool) const, void*), as::asCALL_THISCALL));
+        _(ok, engine->RegisterObjectMethod(type.c_str(), (subtype + " Get(const ContentId&in id, bool silent = true)").c_str(), as::asMETHODPR(Content::Cache, Get, (const Content::Id&, bool) const, void*), as::asCALL_THISCALL));
     }
 
     return ok;
@@ -3,6 +3,9 @@
 #include "Log.hpp"
 #include "Text.hpp"
 
+#include <algorithm>
+#include <chrono>
+
 using namespace std::literals::string_literals;
 
 //
@@ -55,12 +58,22 @@ std::string EWAN::Script::Event::GetDeclaration(as::asIScriptFunction* function)
     return GetDeclaration(name);
 }
 
-void EWAN::Script::Event::Register(as::asIScriptFunction* function)
+const std::list<as::asIScriptFunction*>& EWAN::Script::Event::GetFunctions() const
+{
+    return Functions;
+}
+
+void EWAN::Script::Event::Register(as::asIScriptFunction* function, int32_t priority /*= 0 */)
 {
     if(UserData::Get(function)->Debug)
-        WriteInfo(function->GetEngine(), "Registered event callback : "s + function->GetDeclaration(true, true, true) + " = " + Name + ";", function->GetModuleName());
+        WriteInfo(function->GetEngine(), "Registered event callback : "s + function->GetDeclaration(true, true, true) + " = " + Name + " priority=" + std::to_string(priority) + ";", function->GetModuleName());
+
+    auto it = std::find_if(Functions.begin(), Functions.end(), [this, priority](as::asIScriptFunction* registered) -> bool {
+        return Priorities.at(registered) < priority;
+    });
 
-    Functions.push_back(function);
+    Functions.insert(it, function);
+    Priorities[function] = priority;
 }
 
 void EWAN::Script::Event::Unregister(as::asIScriptEngine* engine)
@@ -79,11 +92,16 @@ void EWAN::Script::Event::Unregister(as::asIScriptModule* module)
             if(UserData::Get(function)->Debug)
                 WriteInfo(module->GetEngine(), "Unregistered event callback : "s + function->GetDeclaration(true, true, true) + " = " + Name + ";", function->GetModuleName());
 
+            Priorities.erase(function);
             return true;
         }
 
         return false;
     });
+
+    // Run() does nothing once all callbacks are gone
+    if(Functions.empty())
+        Consumed = false;
 }
 
 bool EWAN::Script::Event::Run()
@@ -106,6 +124,18 @@ bool EWAN::Script::Event::Run(const int32_t& arg0)
     return Run(init, NOP);
 }
 
+bool EWAN::Script::Event::Run(const float& arg0)
+{
+    if(Functions.empty())
+        return true;
+
+    auto init = [arg0](as::asIScriptContext* context) {
+        context->SetArgFloat(0, arg0);
+    };
+
+    return Run(init, NOP);
+}
+
 bool EWAN::Script::Event::Run(const int32_t& arg0, const int32_t& arg1)
 {
     if(Functions.empty())
@@ -119,6 +149,57 @@ bool EWAN::Script::Event::Run(const int32_t& arg0, const int32_t& arg1)
     return Run(init, NOP);
 }
 
+bool EWAN::Script::Event::Run(const uint32_t& arg0, const bool& arg1, const std::string& arg2)
+{
+    if(Functions.empty())
+        return true;
+
+    auto init = [arg0, arg1, &arg2](as::asIScriptContext* context) {
+        context->SetArgDWord(0, arg0);
+        context->SetArgByte(1, arg1);
+        context->SetArgObject(2, const_cast<std::string*>(&arg2));
+    };
+
+    return Run(init, NOP);
+}
+
+bool EWAN::Script::Event::Run(const std::string& arg0)
+{
+    if(Functions.empty())
+        return true;
+
+    auto init = [&arg0](as::asIScriptContext* context) {
+        context->SetArgObject(0, const_cast<std::string*>(&arg0));
+    };
+
+    return Run(init, NOP);
+}
+
+bool EWAN::Script::Event::Run(const std::string& arg0, const bool& arg1)
+{
+    if(Functions.empty())
+        return true;
+
+    auto init = [&arg0, arg1](as::asIScriptContext* context) {
+        context->SetArgObject(0, const_cast<std::string*>(&arg0));
+        context->SetArgByte(1, arg1);
+    };
+
+    return Run(init, NOP);
+}
+
+bool EWAN::Script::Event::Run(void* arg0)
+{
+    if(Functions.empty())
+        return true;
+
+    auto init = [arg0](as::asIScriptContext* context) {
+        context->SetArgAddress(0, arg0);
+    };
+
+    return Run(init, NOP);
+}
+
 bool EWAN::Script::Event::RunBool(bool& result)
 {
     if(Functions.empty())
@@ -133,10 +214,11 @@ bool EWAN::Script::Event::RunBool(bool& result)
 
 bool EWAN::Script::Event::Run(std::function<void(as::asIScriptContext* context)> init, std::function<void(as::asIScriptContext* context)> finish)
 {
+    Consumed = false;
+
     if(Functions.empty())
         return true;
 
-    // In perfect scenario, only one context is used for N functions
     as::asIScriptContext* context = nullptr;
 
     std::queue<as::asIScriptContext*> yield;
@@ -146,13 +228,13 @@ bool EWAN::Script::Event::Run(std::function<void(as::asIScriptContext* context)>
 
     for(const auto& function : Functions)
     {
+        // Every callback gets context which was used for it previously (if available), making Prepare() cheap for hot events
+        Script* script = UserData::Get(function->GetEngine())->Script;
+        context        = script->RequestContext(function->GetEngine(), script->IsDebugFunction(function), function);
         if(!context)
-        {
-            // Request new context on first function and after yield
+            return false;
 
-            context                       = function->GetEngine()->RequestContext();
-            UserData::Get(context)->Event = this;
-        }
+        UserData::Get(context)->Event = this;
 
         int r = context->Prepare(function);
         if(r != as::asSUCCESS)
@@ -162,17 +244,34 @@ bool EWAN::Script::Event::Run(std::function<void(as::asIScriptContext* context)>
             return false;
         }
 
-        if(UserData::Get(function)->Debug)
+        UserData::Function* functionData = UserData::Get(function);
+        UserData::Get(context)->Function = function;
+        functionData->Stats.Calls++;
+
+        if(functionData->Debug)
             WriteInfo(context->GetEngine(), "Run event : "s + function->GetDeclaration(true, true, true) + " = " + Name + ";", function->GetModuleName());
 
         init(context);
         Execute(context, yield, finish);
-    }
 
-    if(context)
-    {
-        context->GetEngine()->ReturnContext(context);
-        context = nullptr;
+        // Yielded callbacks cannot consume event
+        const bool consumed = Consumable && context && context->GetState() == as::asEXECUTION_FINISHED && function->GetReturnTypeId() == as::asTYPEID_BOOL && context->GetReturnByte();
+
+        if(context)
+        {
+            context->GetEngine()->ReturnContext(context);
+            context = nullptr;
+        }
+
+        if(consumed)
+        {
+            Consumed = true;
+
+            if(functionData->Debug)
+                WriteInfo(function->GetEngine(), "Consumed event : "s + function->GetDeclaration(true, true, true) + " = " + Name + ";", function->GetModuleName());
+
+            break;
+        }
     }
 
     // Secondary run
@@ -199,7 +298,12 @@ bool EWAN::Script::Event::Run(std::function<void(as::asIScriptContext* context)>
 
 bool EWAN::Script::Event::Execute(as::asIScriptContext*& context, std::queue<as::asIScriptContext*>& yield, std::function<void(as::asIScriptContext* context)> finish)
 {
+    UserData::Function* callbackData = UserData::Get(UserData::Get(context)->Function);
+
+    const auto start = std::chrono::steady_clock::now();
     const int  r     = context->Execute();
+    callbackData->Stats.Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
     const bool debug = UserData::Get(context->GetFunction())->Debug;
 
     if(r == as::asEXECUTION_FINISHED)
@@ -217,6 +321,7 @@ bool EWAN::Script::Event::Execute(as::asIScriptContext*& context, std::queue<as:
                 WriteInfo(context->GetEngine(), "Suspend event : "s + context->GetFunction()->GetDeclaration(true, true, true) + " = " + Name + ";", context->GetFunction()->GetModuleName());
 
             // Move context to suspended functions container; as it holds function state it cannot be reused (obviously)
+            callbackData->Stats.Yields++;
             contextData->SuspendReason = SuspendReason::Unknown;
             yield.push(context);
             context = nullptr;
@@ -248,6 +353,7 @@ bool EWAN::Script::Event::RunOnBuild(as::asIScriptModule* module)
     // Make sure event runs only once per module
     Event self = *this;
     Functions.clear();
+    Priorities.clear();
     bool result = self.Run();
 
     // That big boy over here exists only to provide feedback in log
@@ -0,0 +1,178 @@
+#include "Script.hpp"
+
+#include <atomic>
+#include <cstdlib>
+
+namespace
+{
+    // Every block starts with header, user memory starts right after it
+    struct alignas(16) Header
+    {
+        size_t   Size;
+        uint32_t Class;
+    };
+
+    // Used only while block is in pool
+    struct Block
+    {
+        Block* Next;
+    };
+
+    struct Pool
+    {
+        std::atomic_flag Lock = ATOMIC_FLAG_INIT;
+        Block*           Free = nullptr;
+    };
+
+    class SpinLock
+    {
+        std::atomic_flag& Flag;
+
+    public:
+        explicit SpinLock(std::atomic_flag& flag) :
+            Flag(flag)
+        {
+            while(Flag.test_and_set(std::memory_order_acquire))
+            {}
+        }
+
+        ~SpinLock()
+        {
+            Flag.clear(std::memory_order_release);
+        }
+    };
+
+    // Size classes: 16, 32, 48, ... 256 bytes
+    static constexpr size_t   ClassStep  = 16;
+    static constexpr size_t   ClassCount = 16;
+    static constexpr uint32_t ClassLarge = ClassCount;
+    static constexpr size_t   ChunkSize  = 64 * 1024;
+
+    static Pool Pools[ClassCount];
+
+    static std::atomic<uint64_t> Allocations {0};
+    static std::atomic<uint64_t> Frees {0};
+    static std::atomic<uint64_t> Bytes {0};
+    static std::atomic<uint64_t> PoolBytes {0};
+
+    static std::atomic<uint32_t> FrameAllocations {0};
+    static std::atomic<uint32_t> FrameFrees {0};
+    static std::atomic<uint64_t> FrameBytes {0};
+
+    // Must be called with pool lock held
+    static Block* Refill(size_t poolClass)
+    {
+        const size_t blockSize = sizeof(Header) + (poolClass + 1) * ClassStep;
+        const size_t count     = ChunkSize / blockSize;
+
+        uint8_t* chunk = static_cast<uint8_t*>(std::malloc(count * blockSize));
+        if(!chunk)
+            return nullptr;
+
+        PoolBytes.fetch_add(count * blockSize, std::memory_order_relaxed);
+
+        Block* head = nullptr;
+        for(size_t b = count; b > 0; b--)
+        {
+            Block* block = reinterpret_cast<Block*>(chunk + (b - 1) * blockSize);
+            block->Next  = head;
+            head         = block;
+        }
+
+        return head;
+    }
+}
+
+//
+// Script::Memory
+//
+
+/* static */ bool EWAN::Script::Memory::Init()
+{
+    // Memory functions cannot be changed while any engine is alive,
+    // and there's no need to do that after App restart
+    static const bool installed = as::asSetGlobalMemoryFunctions(Alloc, Free) >= 0;
+
+    return installed;
+}
+
+/* static */ void* EWAN::Script::Memory::Alloc(size_t size)
+{
+    const size_t poolClass = size ? (size - 1) / ClassStep : 0;
+    Header*      header    = nullptr;
+
+    if(poolClass < ClassCount)
+    {
+        Pool&    pool = Pools[poolClass];
+        SpinLock lock(pool.Lock);
+
+        if(!pool.Free)
+            pool.Free = Refill(poolClass);
+
+        if(!pool.Free)
+            return nullptr;
+
+        header    = reinterpret_cast<Header*>(pool.Free);
+        pool.Free = pool.Free->Next;
+
+        header->Class = static_cast<uint32_t>(poolClass);
+    }
+    else
+    {
+        header = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+        if(!header)
+            return nullptr;
+
+        header->Class = ClassLarge;
+    }
+
+    header->Size = size;
+
+    Allocations.fetch_add(1, std::memory_order_relaxed);
+    Bytes.fetch_add(size, std::memory_order_relaxed);
+    FrameAllocations.fetch_add(1, std::memory_order_relaxed);
+    FrameBytes.fetch_add(size, std::memory_order_relaxed);
+
+    return header + 1;
+}
+
+/* static */ void EWAN::Script::Memory::Free(void* memory)
+{
+    if(!memory)
+        return;
+
+    Header* header = static_cast<Header*>(memory) - 1;
+
+    Frees.fetch_add(1, std::memory_order_relaxed);
+    Bytes.fetch_sub(header->Size, std::memory_order_relaxed);
+    FrameFrees.fetch_add(1, std::memory_order_relaxed);
+
+    if(header->Class == ClassLarge)
+    {
+        std::free(header);
+        return;
+    }
+
+    Pool&    pool = Pools[header->Class];
+    SpinLock lock(pool.Lock);
+
+    Block* block = reinterpret_cast<Block*>(header);
+    block->Next  = pool.Free;
+    pool.Free    = block;
+}
+
+/* static */ EWAN::Script::Memory::Stats EWAN::Script::Memory::NewFrame()
+{
+    Stats stats;
+
+    stats.Allocations = Allocations.load(std::memory_order_relaxed);
+    stats.Frees       = Frees.load(std::memory_order_relaxed);
+    stats.Bytes       = Bytes.load(std::memory_order_relaxed);
+    stats.PoolBytes   = PoolBytes.load(std::memory_order_relaxed);
+
+    stats.FrameAllocations = FrameAllocations.exchange(0, std::memory_order_relaxed);
+    stats.FrameFrees       = FrameFrees.exchange(0, std::memory_order_relaxed);
+    stats.FrameBytes       = FrameBytes.exchange(0, std::memory_order_relaxed);
+
+    return stats;
+}
@@ -1,5 +1,7 @@
 #include "Script.hpp"
 
+#include <algorithm>
+
 /* static */ EWAN::Script::UserData::Context* EWAN::Script::UserData::Get(as::asIScriptContext* context)
 {
     return static_cast<Context*>(context->GetUserData(UserData::IDX));
@@ -19,3 +21,47 @@
 {
     return static_cast<Module*>(module->GetUserData(UserData::IDX));
 }
+
+//
+
+void EWAN::Script::UserData::FunctionStats::Record(int64_t time)
+{
+    TimeTotal += time;
+    TimeMax = std::max(TimeMax, time);
+
+    Samples[SamplesCount % SamplesSize] = time;
+    SamplesCount++;
+}
+
+void EWAN::Script::UserData::FunctionStats::Reset()
+{
+    *this = FunctionStats();
+}
+
+int64_t EWAN::Script::UserData::FunctionStats::GetTimeMean() const
+{
+    if(!Calls)
+        return 0;
+
+    return TimeTotal / Calls;
+}
+
+int64_t EWAN::Script::UserData::FunctionStats::GetTimePercentile(uint8_t percentile) const
+{
+    const size_t size = std::min(SamplesCount, SamplesSize);
+    if(!size)
+        return 0;
+
+    // Samples are kept in ring buffer; sort a copy to keep recording order intact
+    std::array<int64_t, SamplesSize> sorted = Samples;
+    const size_t                     rank   = std::max<size_t>((size * std::min<size_t>(percentile, 100) + 99) / 100, 1) - 1;
+
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(rank), sorted.begin() + static_cast<std::ptrdiff_t>(size));
+
+    return sorted[rank];
+}
+
+int64_t EWAN::Script::UserData::FunctionStats::GetTimeP99() const
+{
+    return GetTimePercentile(99);
+}
@@ -0,0 +1,293 @@
+#include "Script.hpp"
+
+#include "Log.hpp"
+#include "Text.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+using namespace std::literals::string_literals;
+
+namespace
+{
+    // Only `#pragma module worker` matters for worker engines, other module setup is left to main thread
+    static int WorkerPragma(const std::string& pragmaText, as::CScriptBuilder&, void* data)
+    {
+        std::vector<std::string> pragmargs = EWAN::Text::Split(EWAN::Text::Trim(EWAN::Text::Replace(pragmaText, "\t", " ")), ' ');
+
+        if(pragmargs.size() == 2 && pragmargs.at(0) == "module" && pragmargs.at(1) == "worker")
+            *static_cast<bool*>(data) = true;
+
+        return 0;
+    }
+}
+
+//
+// Script::Worker
+//
+
+EWAN::Script::Worker::Worker()
+{}
+
+EWAN::Script::Worker::~Worker()
+{
+    Finish();
+}
+
+void EWAN::Script::Worker::Init(const std::string& namespace_)
+{
+    Namespace = namespace_;
+}
+
+void EWAN::Script::Worker::Finish()
+{
+    if(Threads.empty())
+        return;
+
+    // Jobs which are already running are aborted, threads never wait for them to finish
+    {
+        std::lock_guard<std::mutex> lock(QueueLock);
+        Stopping = true;
+
+        for(as::asIScriptContext* context : Contexts)
+        {
+            context->Abort();
+        }
+    }
+    QueueSignal.notify_all();
+
+    for(auto& thread : Threads)
+    {
+        thread.join();
+    }
+
+    Threads.clear();
+    Contexts.clear();
+    Queue.clear();
+    Finished.clear();
+    Stopping = false;
+}
+
+uint32_t EWAN::Script::Worker::Spawn(const std::string& fileName, const std::string& function, const std::string& data)
+{
+    if(Threads.empty())
+    {
+        const size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+
+        Log::PrintInfo("Worker initialization... " + std::to_string(threads) + " thread(s)");
+        for(size_t t = 0; t < threads; t++)
+        {
+            Threads.emplace_back(&Worker::ThreadMain, this);
+        }
+    }
+
+    Job job;
+    job.FileName = std::filesystem::path(fileName).make_preferred().string();
+    job.Function = function;
+    job.Data     = data;
+
+    {
+        std::lock_guard<std::mutex> lock(QueueLock);
+
+        // Zero is reserved for errors
+        if(++LastID == 0)
+            ++LastID;
+
+        job.ID = LastID;
+        Queue.push_back(job);
+    }
+    QueueSignal.notify_one();
+
+    return job.ID;
+}
+
+bool EWAN::Script::Worker::Collect(Job& job)
+{
+    std::lock_guard<std::mutex> lock(QueueLock);
+
+    if(Finished.empty())
+        return false;
+
+    job = std::move(Finished.front());
+    Finished.pop_front();
+
+    return true;
+}
+
+//
+
+void EWAN::Script::Worker::ThreadMain()
+{
+    std::string namespace_;
+    {
+        std::lock_guard<std::mutex> lock(QueueLock);
+        namespace_ = Namespace;
+    }
+
+    // Engine is created on first job, and lives as long as thread
+    as::asIScriptEngine*  engine  = nullptr;
+    as::asIScriptContext* context = nullptr;
+
+    // Modification time of every script file built by this thread
+    std::map<std::string, std::filesystem::file_time_type> sources;
+
+    while(true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(QueueLock);
+            QueueSignal.wait(lock, [this] { return Stopping || !Queue.empty(); });
+
+            if(Stopping)
+                break;
+
+            job = std::move(Queue.front());
+            Queue.pop_front();
+        }
+
+        if(!engine)
+        {
+            engine = CreateEngine(namespace_);
+            if(engine)
+                context = engine->CreateContext();
+
+            // Context must be reachable by Finish(), so running job can be aborted
+            if(context)
+            {
+                std::lock_guard<std::mutex> lock(QueueLock);
+                Contexts.push_back(context);
+            }
+        }
+
+        job.Success = engine && context && Execute(engine, context, sources, job);
+        if(!job.Success)
+            job.Data.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(QueueLock);
+            Finished.push_back(std::move(job));
+        }
+    }
+
+    if(context)
+    {
+        {
+            std::lock_guard<std::mutex> lock(QueueLock);
+            Contexts.erase(std::remove(Contexts.begin(), Contexts.end(), context), Contexts.end());
+        }
+
+        context->Release();
+    }
+
+    if(engine)
+        engine->ShutDownAndRelease();
+
+    as::asThreadCleanup();
+}
+
+/* static */ as::asIScriptEngine* EWAN::Script::Worker::CreateEngine(const std::string& namespace_)
+{
+    as::asIScriptEngine* engine = as::asCreateScriptEngine();
+    if(!engine)
+    {
+        Log::PrintError("Worker : cannot create engine");
+        return nullptr;
+    }
+
+    if(!SetEngineProperties(engine) || !API::InitWorker(engine, namespace_))
+    {
+        WriteError(engine, "Worker : cannot register API");
+        engine->ShutDownAndRelease();
+        return nullptr;
+    }
+
+    return engine;
+}
+
+/* static */ as::asIScriptModule* EWAN::Script::Worker::LoadModule(as::asIScriptEngine* engine, const std::string& fileName, std::map<std::string, std::filesystem::file_time_type>& sources)
+{
+    std::error_code                       error;
+    const std::filesystem::file_time_type time = std::filesystem::last_write_time(fileName, error);
+
+    // Module name is set to script filename, so each file is built only once per thread, and rebuilt when it changes
+    as::asIScriptModule* module = engine->GetModule(fileName.c_str(), as::asGM_ONLY_IF_EXISTS);
+    if(module)
+    {
+        auto source = sources.find(fileName);
+        if(!error && source != sources.end() && source->second == time)
+            return module;
+
+        module->Discard();
+        sources.erase(fileName);
+    }
+
+    bool               worker = false;
+    as::CScriptBuilder builder;
+    builder.SetPragmaCallback(WorkerPragma, &worker);
+
+    if(builder.StartNewModule(engine, fileName.c_str()) < 0)
+        return nullptr;
+
+    module = builder.GetModule();
+
+    if(builder.AddSectionFromFile(fileName.c_str()) < 0 || !worker || builder.BuildModule() < 0)
+    {
+        if(!worker)
+            WriteError(engine, "Worker : module is not marked with `#pragma module worker`", fileName);
+
+        module->Discard();
+        return nullptr;
+    }
+
+    if(!error)
+        sources[fileName] = time;
+
+    return module;
+}
+
+bool EWAN::Script::Worker::Execute(as::asIScriptEngine* engine, as::asIScriptContext* context, std::map<std::string, std::filesystem::file_time_type>& sources, Job& job)
+{
+    as::asIScriptModule* module = LoadModule(engine, job.FileName, sources);
+    if(!module)
+        return false;
+
+    const std::string      declaration = "string "s + job.Function + "(const string&in)";
+    as::asIScriptFunction* function    = module->GetFunctionByDecl(declaration.c_str());
+    if(!function)
+    {
+        WriteError(engine, "Worker : function not found : " + declaration, job.FileName);
+        return false;
+    }
+
+    if(context->Prepare(function) < 0)
+        return false;
+
+    context->SetArgObject(0, &job.Data);
+
+    // Finish() may abort context only after it's been prepared, otherwise Prepare() would reset abort request
+    {
+        std::lock_guard<std::mutex> lock(QueueLock);
+        if(Stopping)
+        {
+            context->Unprepare();
+            return false;
+        }
+    }
+
+    const int r = context->Execute();
+    if(r != as::asEXECUTION_FINISHED)
+    {
+        if(r == as::asEXECUTION_EXCEPTION)
+            WriteError(engine, "Worker : "s + context->GetExceptionString(), job.FileName);
+        else if(r != as::asEXECUTION_ABORTED)
+            WriteError(engine, "Worker : cannot execute job : Execute() = " + std::to_string(r), job.FileName);
+
+        context->Unprepare();
+        return false;
+    }
+
+    job.Data = *static_cast<std::string*>(context->GetReturnObject());
+    context->Unprepare();
+
+    return true;
+}
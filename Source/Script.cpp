@@ -5,11 +5,109 @@
 #include "Text.hpp"
 #include "Utils.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <filesystem>
+#include <sstream>
 #include <unordered_map>
 
 using namespace std::literals::string_literals;
 
+namespace
+{
+    // Generates module with single function `LazyStub`, matching signature of given imported function
+    //
+    // "int ns::Work(int, const string&in)" from "Lazy" turns into:
+    //
+    //   namespace ns { import int Work(int, const string&in) from "Lazy";
+    //   int LazyStub(int a0, const string&in a1) { App.Script.LoadLazy("Lazy"); return Work(a0, a1); } }
+    //
+    static std::string GetLazyStubSource(const std::string& declaration, const std::string& moduleName)
+    {
+        const size_t open  = declaration.find('(');
+        const size_t close = declaration.rfind(')');
+        if(open == std::string::npos || close == std::string::npos || close < open)
+            return {};
+
+        const std::string head  = EWAN::Text::Trim(declaration.substr(0, open));
+        const size_t      space = head.rfind(' ');
+        if(space == std::string::npos)
+            return {};
+
+        const std::string returnType = head.substr(0, space);
+        std::string       name       = head.substr(space + 1);
+        std::string       ns;
+
+        const size_t colon = name.rfind("::");
+        if(colon != std::string::npos)
+        {
+            ns   = name.substr(0, colon);
+            name = name.substr(colon + 2);
+        }
+
+        // Split parameters list, ignoring commas inside templates
+        std::vector<std::string> params;
+        std::string              param;
+        int                      depth = 0;
+        for(const char c : declaration.substr(open + 1, close - open - 1))
+        {
+            if(c == '<' || c == '(')
+                depth++;
+            else if(c == '>' || c == ')')
+                depth--;
+
+            if(c == ',' && depth == 0)
+            {
+                params.push_back(param);
+                param.clear();
+            }
+            else
+                param += c;
+        }
+        params.push_back(param);
+
+        // Default arguments are resolved by caller, stubs always receives all of them
+        for(auto& p : params)
+        {
+            p = EWAN::Text::Trim(p.substr(0, p.find('=')));
+        }
+
+        if(params.size() == 1 && (params.front().empty() || params.front() == "void"))
+            params.clear();
+
+        std::string importParams, stubParams, callArgs;
+        for(size_t p = 0; p < params.size(); p++)
+        {
+            const std::string separator = p ? ", " : "";
+            const std::string arg       = "a" + std::to_string(p);
+
+            importParams += separator + params[p];
+            stubParams += separator + params[p] + " " + arg;
+            callArgs += separator + arg;
+        }
+
+        std::string source;
+        source += "import " + returnType + " " + name + "(" + importParams + ") from \"" + moduleName + "\";\n";
+        source += returnType + " LazyStub(" + stubParams + ")\n";
+        source += "{\n";
+        source += "    App.Script.LoadLazy(\"" + moduleName + "\");\n";
+        source += "    "s + (returnType == "void" ? "" : "return ") + name + "(" + callArgs + ");\n";
+        source += "}\n";
+
+        if(!ns.empty())
+        {
+            const std::vector<std::string> namespaces = EWAN::Text::Split(EWAN::Text::Replace(ns, "::", ":"), ':');
+            for(auto it = namespaces.rbegin(); it != namespaces.rend(); it++)
+            {
+                source = "namespace " + *it + "\n{\n" + source + "}\n";
+            }
+        }
+
+        return source;
+    }
+}
+
 //
 // Script
 //
@@ -36,22 +134,40 @@ EWAN::Script::Script() :
     OnInit("OnInit", {"bool"}),
     OnFinish("OnFinish", {"void"}),
     OnDraw("OnDraw", {"void"}),
+    OnDrawLayer("OnDrawLayer", {"void", "const string&in"}),
+    OnUpdate("OnUpdate", {"void", "const float"}),
     OnKeyDown("OnKeyDown", {"void", "const ?::Key"}),
     OnKeyUp("OnKeyUp", {"void", "const ?::Key"}),
     OnMouseDown("OnMouseDown", {"void", "const ?::MouseButton"}),
     OnMouseUp("OnMouseUp", {"void", "const ?::MouseButton"}),
-    OnMouseMove("OnMouseMove", {"void", "const int32", "const int32"})
+    OnMouseMove("OnMouseMove", {"void", "const int32", "const int32"}),
+    OnInputFrame("OnInputFrame", {"void", "?::InputBatch@"}),
+    OnJob("OnJob", {"void", "const uint32", "const bool", "const string&in"}),
+    OnModuleLoaded("OnModuleLoaded", {"void", "const string&in", "const bool"})
 {
     // Cache all events in single container, for easier mass-processing
     AllEvents.push_back(&OnBuild);
     AllEvents.push_back(&OnInit);
     AllEvents.push_back(&OnFinish);
     AllEvents.push_back(&OnDraw);
+    AllEvents.push_back(&OnDrawLayer);
+    AllEvents.push_back(&OnUpdate);
     AllEvents.push_back(&OnKeyDown);
     AllEvents.push_back(&OnKeyUp);
     AllEvents.push_back(&OnMouseDown);
     AllEvents.push_back(&OnMouseUp);
     AllEvents.push_back(&OnMouseMove);
+    AllEvents.push_back(&OnInputFrame);
+    AllEvents.push_back(&OnJob);
+    AllEvents.push_back(&OnModuleLoaded);
+
+    // Input events can be stopped by callbacks, e.g. when UI handles click
+    OnKeyDown.Consumable    = true;
+    OnKeyUp.Consumable      = true;
+    OnMouseDown.Consumable  = true;
+    OnMouseUp.Consumable    = true;
+    OnMouseMove.Consumable  = true;
+    OnInputFrame.Consumable = true;
 }
 
 EWAN::Script::~Script()
@@ -98,6 +214,21 @@ bool EWAN::Script::Init(App* app)
         return false;
     }
 
+    // Pre-warm context pool, so first frames doesn't pay for creating contexts
+
+    for(uint32_t c = 0; c < ContextPoolSize; c++)
+    {
+        as::asIScriptContext* context = RequestContext(engine, false);
+        if(!context)
+        {
+            WriteError(engine, fail + "cannot create script context");
+            DestroyEngine(engine);
+            return false;
+        }
+
+        engine->ReturnContext(context);
+    }
+
     // Replace root namespace placeholder with real value
 
     for(const auto& event : AllEvents)
@@ -134,6 +265,13 @@ bool EWAN::Script::Init(App* app)
         return false;
     }
 
+    // Stubs are created when binding imports, lazy modules without any can only be built with Script.LoadLazy()
+    for(const auto& [lazyName, lazy] : LazyModules)
+    {
+        if(lazy.Stubs.empty())
+            WriteWarning(engine, "Lazy module is not imported by any module, it will not be built until Script.LoadLazy() is called", lazyName);
+    }
+
     // [OnInit] always clears Event.OnInit
     // `falseFunction` points to first script function which returned false (if any)
     {
@@ -180,8 +318,13 @@ bool EWAN::Script::Init(App* app)
         return false;
     }
 
+    Workers.Init(app->GameInfo.ScriptNamespace);
+
     WriteInfo(engine, "Script initialization complete");
-    AS = engine;
+    AS         = engine;
+    StatsTime  = std::chrono::steady_clock::now();
+    ReloadTime = StatsTime;
+    Garbage    = GarbageStats();
 
     return true;
 }
@@ -192,6 +335,11 @@ void EWAN::Script::Finish()
     {
         Log::PrintInfo("Script finalization...");
 
+        // Results of unfinished jobs are dropped, same goes for modules which are not loaded yet
+        Workers.Finish();
+        PendingModules.clear();
+        LazyModules.clear();
+
         OnFinish.IgnoreExecuteErrors = true;
         OnFinish.Run();
         OnFinish.Unregister(AS);
@@ -201,6 +349,78 @@ void EWAN::Script::Finish()
     }
 }
 
+void EWAN::Script::Update()
+{
+    Worker::Job job;
+    while(Workers.Collect(job))
+    {
+        OnJob.Run(job.ID, job.Success, job.Data);
+    }
+
+    CommitModules();
+
+    MemoryStats = Memory::NewFrame();
+
+    if(ReloadInterval > 0.0f)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if(std::chrono::duration<float>(now - ReloadTime).count() >= ReloadInterval)
+        {
+            ReloadTime      = now;
+            ReloadRequested = true;
+        }
+    }
+
+    if(ReloadRequested)
+    {
+        ReloadRequested = false;
+        ReloadModules();
+    }
+
+    if(StatsInterval > 0.0f)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if(std::chrono::duration<float>(now - StatsTime).count() >= StatsInterval)
+        {
+            StatsTime = now;
+            LogStats();
+        }
+    }
+}
+
+void EWAN::Script::GarbageCollect(uint32_t budget)
+{
+    if(!AS)
+        return;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    Garbage.FrameSteps = 0;
+
+    // Stop as soon as collector finishes full cycle; new one will be started next frame
+    int r;
+    do
+    {
+        r = AS->GarbageCollect(as::asGC_ONE_STEP | as::asGC_DETECT_GARBAGE | as::asGC_DESTROY_GARBAGE);
+        Garbage.FrameSteps++;
+    }
+    while(r == 1 && std::chrono::steady_clock::now() - start < std::chrono::microseconds(budget));
+
+    if(r < 0)
+        WriteError(AS, "Cannot run garbage collection step : GarbageCollect() = " + std::to_string(r));
+
+    Garbage.FrameTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    Garbage.TimeTotal += Garbage.FrameTime;
+    Garbage.TimeMax = std::max(Garbage.TimeMax, Garbage.FrameTime);
+
+    as::asUINT alive = 0, destroyed = 0, detected = 0;
+    AS->GetGCStatistics(&alive, &destroyed, &detected);
+
+    Garbage.Alive     = alive;
+    Garbage.Destroyed = destroyed;
+    Garbage.Detected  = detected;
+}
+
 //
 
 /* static */ void EWAN::Script::WriteInfo(as::asIScriptEngine* engine, const std::string& message, const std::string& section /*= {} */, int row /*= 0 */, int col /*= 0 */)
@@ -231,7 +451,7 @@ bool EWAN::Script::LoadModule(as::asIScriptEngine* engine, const std::string& fi
     }
 
     as::asIScriptModule* module = engine->GetModule(moduleName.c_str(), as::asGM_ONLY_IF_EXISTS);
-    if(module)
+    if(module || LazyModules.count(moduleName))
     {
         WriteError(engine, "Cannot load module (name already in use) : ", moduleName);
         return false;
@@ -247,9 +467,25 @@ bool EWAN::Script::LoadModule(as::asIScriptEngine* engine, const std::string& fi
 
     module = builder.GetModule();
 
+    UserData::Module* moduleData = UserData::Get(module);
+    moduleData->FileName         = fileName;
+    moduleData->LoadName         = moduleName;
+
+    auto time = std::chrono::steady_clock::now();
+
+    // Returns microseconds since previous call
+    const auto elapsed = [&time]() -> int64_t {
+        const auto now    = std::chrono::steady_clock::now();
+        const auto result = std::chrono::duration_cast<std::chrono::microseconds>(now - time).count();
+        time              = now;
+
+        return result;
+    };
+
     // Using AddSectionFromMemory() instead of AddSectionFromFile() for custom script sections names
-    std::string fileContent;
-    if(!Utils::ReadFile(fileName, fileContent))
+    const std::string* fileContent = ReadSource(module, fileName);
+    moduleData->TimeRead += elapsed();
+    if(!fileContent)
     {
         WriteInfo(engine, fail, module->GetName());
         UnloadModule(module);
@@ -260,7 +496,9 @@ bool EWAN::Script::LoadModule(as::asIScriptEngine* engine, const std::string& fi
     // Section name is set to script filename relative to RootDirectory, with enforced *NIX path separators
     const std::string sectionName = Text::Replace(std::filesystem::relative(fileName, RootDirectory).string(), "\\", "/");
 
-    r = builder.AddSectionFromMemory(sectionName.c_str(), fileContent.c_str());
+    const int64_t readIncludes = moduleData->TimeRead;
+    r                          = builder.AddSectionFromMemory(sectionName.c_str(), fileContent->c_str());
+    moduleData->TimePreprocess = elapsed() - (moduleData->TimeRead - readIncludes);
     if(r < 0)
     {
         WriteInfo(engine, fail, module->GetName());
@@ -271,9 +509,27 @@ bool EWAN::Script::LoadModule(as::asIScriptEngine* engine, const std::string& fi
 
     /*/ At this point all non-instant `#pragma module` directives are available as UserData::Module /*/
 
+    // Building lazy modules is delayed until they're needed, see LoadLazyModule()
+    if(moduleData->Lazy && !LazyBuilding)
+    {
+        const std::string lazyName = module->GetName();
+
+        LazyModule lazy;
+        lazy.FileName = fileName;
+        lazy.LoadName = moduleName;
+
+        UnloadModule(module);
+        LazyModules.emplace(lazyName, std::move(lazy));
+
+        WriteInfo(engine, "Loading module deferred", lazyName);
+
+        return true;
+    }
+
     // Optional modules does not inform caller about failure
-    bool optional = UserData::Get(module)->Optional;
-    r             = builder.BuildModule();
+    bool optional         = moduleData->Optional;
+    r                     = builder.BuildModule();
+    moduleData->TimeBuild = elapsed();
     if(r < 0)
     {
         WriteError(engine, fail, module->GetName());
@@ -289,7 +545,9 @@ bool EWAN::Script::LoadModule(as::asIScriptEngine* engine, const std::string& fi
     }
 
     // [OnBuild] always clears OnBuild.Functions
-    if(!LoadModuleMetadata(builder) || !OnBuild.RunOnBuild(module))
+    const bool metadata      = LoadModuleMetadata(builder);
+    moduleData->TimeMetadata = elapsed();
+    if(!metadata || !OnBuild.RunOnBuild(module))
     {
         WriteError(engine, fail, module->GetName());
         UnloadModule(module);
@@ -297,7 +555,7 @@ bool EWAN::Script::LoadModule(as::asIScriptEngine* engine, const std::string& fi
         return optional;
     }
 
-    WriteInfo(engine, "Loading module complete", module->GetName());
+    WriteInfo(engine, "Loading module complete : read=" + std::to_string(moduleData->TimeRead) + "us preprocess=" + std::to_string(moduleData->TimePreprocess) + "us build=" + std::to_string(moduleData->TimeBuild) + "us metadata=" + std::to_string(moduleData->TimeMetadata) + "us", module->GetName());
 
     return true;
 }
@@ -319,6 +577,42 @@ bool EWAN::Script::LoadModule_ScriptCall(const std::string& fileName, const std:
     return LoadModule(context->GetEngine(), RootDirectory + fileName, moduleName);
 }
 
+bool EWAN::Script::LoadModuleAsync_ScriptCall(const std::string& fileName, const std::string& moduleName)
+{
+    as::asIScriptContext* context = as::asGetActiveContext();
+    if(!context)
+    {
+        Log::PrintError("LoadModuleAsync : no context");
+        return false;
+    }
+    else if(Text::IsBlank(moduleName))
+    {
+        WriteError(context->GetEngine(), "LoadModuleAsync : moduleName is blank");
+        return false;
+    }
+
+    as::asIScriptEngine* engine = context->GetEngine();
+
+    const bool pending = std::find_if(PendingModules.begin(), PendingModules.end(), [&moduleName](const PendingModule& module) -> bool {
+                             return module.ModuleName == moduleName;
+                         }) != PendingModules.end();
+
+    if(pending || engine->GetModule(moduleName.c_str(), as::asGM_ONLY_IF_EXISTS))
+    {
+        WriteError(engine, "Cannot load module (name already in use) : ", moduleName);
+        return false;
+    }
+
+    PendingModule module;
+    module.FileName   = RootDirectory + fileName;
+    module.ModuleName = moduleName;
+    module.Sources    = std::async(std::launch::async, PrefetchSources, module.FileName);
+
+    PendingModules.push_back(std::move(module));
+
+    return true;
+}
+
 bool EWAN::Script::LoadInitModule(const GameInfo& game, as::asIScriptEngine* engine)
 {
     std::string scriptFile = std::filesystem::path(game.Path).replace_filename(game.ScriptInit).make_preferred().string();
@@ -353,6 +647,7 @@ bool EWAN::Script::UnloadModule(as::asIScriptModule*& module)
         event->Unregister(module);
     }
 
+    UnbindContexts(module);
     module->UnbindAllImportedFunctions();
     module->Discard();
 
@@ -379,162 +674,744 @@ bool EWAN::Script::UnloadModule_ScriptCall(const std::string& moduleName)
     return UnloadModule(module);
 }
 
-bool EWAN::Script::LoadModuleMetadata(Builder& builder)
+bool EWAN::Script::ReloadModule(as::asIScriptModule*& module)
 {
-    bool result = true;
+    static const std::string fail = "Reloading module failed";
 
-    as::asIScriptEngine* engine = builder.GetEngine();
-    as::asIScriptModule* module = builder.GetModule();
+    as::asIScriptEngine* engine = module->GetEngine();
 
-    // Process "slow" pragmas (requires module to be built first)
+    // Loading modules from inside of script functions is fine, replacing them is not
+    if(as::asGetActiveContext())
+    {
+        WriteError(engine, "Cannot reload module (script context is active)", module->GetName());
+        return false;
+    }
 
-    if(UserData::Get(module)->Debug) // #pragma module debug
+    // Copy, as user data is going away together with module
+    const UserData::Module moduleData = *UserData::Get(module);
+    const std::string      moduleName = module->GetName();
+
+    if(moduleData.FileName.empty())
     {
-        for(as::asUINT f = 0, fLen = module->GetFunctionCount(); f < fLen; f++)
-        {
-            as::asIScriptFunction* function = module->GetFunctionByIndex(f);
-            UserData::Get(function)->Debug  = true;
-        }
+        WriteError(engine, "Cannot reload module (source file unknown)", moduleName);
+        return false;
     }
 
-    // Process functions with metadata
+    WriteInfo(engine, "Reloading module...", moduleName);
 
-    for(const auto& metadata : builder.GetAllMetadataForFunc())
+    // Old module is moved out of the way, so new one can use same name; `#pragma module rename` included
+    const std::string oldName = moduleName + "~reload";
+    module->SetName(oldName.c_str());
+
+    // Module being replaced has been built already, `#pragma module lazy` must not defer it again
+    const bool lazyBuilding = LazyBuilding;
+    LazyBuilding            = moduleData.Lazy || LazyBuilding;
+
+    as::asIScriptModule* newModule = nullptr;
+    if(LoadModule(engine, moduleData.FileName, moduleData.LoadName))
+        newModule = engine->GetModule(moduleName.c_str(), as::asGM_ONLY_IF_EXISTS);
+
+    LazyBuilding = lazyBuilding;
+
+    // Optional modules are unloaded silently by LoadModule(), which still counts as failure here
+    if(!newModule || !BindImportedFunctions(newModule))
     {
-        as::asIScriptFunction* function = engine->GetFunctionById(metadata.first);
+        if(newModule)
+            UnloadModule(newModule);
 
-        // Check [Debug *] metadata
-        // This should be checked early, as other metadata might want to generate debug messages
-        for(const auto& metadataText : metadata.second)
-        {
-            std::vector<std::string> text = Text::Split(metadataText, ' ');
+        module->SetName(moduleName.c_str());
+        WriteError(engine, fail, moduleName);
 
-            if(text.front() == "Debug" && text.size() == 2)
-            {
-                if(text.at(1) == "ON")
-                    UserData::Get(function)->Debug = true;
-                else if(text.at(1) == "OFF")
-                    UserData::Get(function)->Debug = false;
-            }
-        }
+        return false;
+    }
 
-        // Check [On*] metadata
-        for(const auto& event : AllEvents)
-        {
-            if(event->Name.substr(0, 2) != "On")
-            {
-                WriteError(engine, "Invalid event name : "s + event->Name);
-                return false;
-            }
+    // [OnInit] is not called for reloaded modules
+    OnInit.Unregister(newModule);
+
+    MigrateGlobalVariables(module, newModule);
+
+    // Rebind everyone who imports anything from reloaded module; lazy stubs included, as they're forwarding calls to it
+    for(as::asUINT m = 0, mLen = engine->GetModuleCount(); m < mLen; m++)
+    {
+        as::asIScriptModule* importer = engine->GetModuleByIndex(m);
+        if(importer == module || importer == newModule)
+            continue;
 
-            if(std::find(metadata.second.begin(), metadata.second.end(), event->Name) != metadata.second.end())
+        for(as::asUINT f = 0, fLen = importer->GetImportedFunctionCount(); f < fLen; f++)
+        {
+            if(importer->GetImportedFunctionSourceModule(f) == moduleName)
             {
-                // This is kind of silly way of validating script function signature, but it works, OK?
-                std::string            expectedDeclaration = event->GetDeclaration(function);
-                as::asIScriptFunction* sameFunction        = module->GetFunctionByDecl(expectedDeclaration.c_str());
-                if(function != sameFunction)
-                {
-                    WriteError(engine, "Invalid function signature for event : " + event->Name + "\nExpected:\n  " + expectedDeclaration + ";\nFound:\n  " + function->GetDeclaration(true, true, false) + ";", module->GetName());
-                    result = false;
-                    continue;
-                }
+                importer->UnbindAllImportedFunctions();
+                if(!BindImportedFunctions(importer))
+                    WriteWarning(engine, "Reloaded module cannot be fully imported", importer->GetName());
 
-                event->Register(function);
+                break;
             }
         }
     }
 
-    return result;
-}
-
-//
-
-std::string EWAN::Script::GetContextFunctionDetails(as::asIScriptContext* context, as::asUINT stackLevel /*= 0 */)
-{
-    int         line, column;
-    const char* sectionName;
-
-    line                            = context->GetLineNumber(stackLevel, &column, &sectionName);
-    as::asIScriptFunction* function = context->GetFunction(stackLevel);
+    // Old functions can still be referenced by suspended contexts; AngelScript keeps them alive until released
+    UnloadModule(module);
+    module = newModule;
 
-    std::string details;
-    details += " "s + function->GetModuleName();
-    details += " "s + sectionName;
-    details += " "s + function->GetDeclaration(true, true, false);
-    details += " "s + std::to_string(line) + "," + std::to_string(column);
+    WriteInfo(engine, "Reloading module complete", moduleName);
 
-    return details.substr(1);
+    return true;
 }
 
-//
-
-std::string EWAN::Script::CurrentEventName_ScriptCall()
+uint32_t EWAN::Script::ReloadModules()
 {
-    as::asIScriptContext* context = as::asGetActiveContext();
-    if(!context)
-        return {};
+    if(!AS)
+        return 0;
 
-    return UserData::Get(context)->Event->Name;
-}
+    // Cache changed modules first so they can be safely reloaded
+    std::vector<as::asIScriptModule*> changedModules;
+    for(as::asUINT m = 0, mLen = AS->GetModuleCount(); m < mLen; m++)
+    {
+        as::asIScriptModule* module = AS->GetModuleByIndex(m);
+        if(IsModuleChanged(module))
+            changedModules.push_back(module);
+    }
 
-void EWAN::Script::Yield_ScriptCall()
-{
-    as::asIScriptContext* context = as::asGetActiveContext();
-    if(!context)
-        return;
+    uint32_t result = 0;
+    for(auto& module : changedModules)
+    {
+        if(ReloadModule(module))
+            result++;
+        else
+        {
+            // Don't retry until module sources are changed again
+            for(auto& source : UserData::Get(module)->Sources)
+            {
+                std::error_code error;
+                source.second = std::filesystem::last_write_time(source.first, error);
+            }
+        }
+    }
 
-    UserData::Get(context)->SuspendReason = SuspendReason::Yield;
-    context->Suspend();
+    return result;
 }
 
-//
+void EWAN::Script::Reload_ScriptCall()
+{
+    // Current context might be using one of reloaded modules, so work is delayed until Update()
+    ReloadRequested = true;
+}
 
-bool EWAN::Script::BindImportedFunctions(as::asIScriptEngine* engine)
+/* static */ bool EWAN::Script::IsModuleChanged(as::asIScriptModule* module)
 {
-    for(as::asUINT m = 0, mLen = engine->GetModuleCount(); m < mLen; m++)
+    for(const auto& source : UserData::Get(module)->Sources)
     {
-        if(!BindImportedFunctions(engine->GetModuleByIndex(m)))
-            return false;
+        std::error_code                       error;
+        const std::filesystem::file_time_type time = std::filesystem::last_write_time(source.first, error);
+
+        // Removed files are not considered as change, module would fail to build anyway
+        if(!error && time != source.second)
+            return true;
     }
 
-    return true;
+    return false;
 }
 
-bool EWAN::Script::BindImportedFunctions(as::asIScriptModule* module)
+/* static */ void EWAN::Script::MigrateGlobalVariables(as::asIScriptModule* from, as::asIScriptModule* to)
 {
-    as::asIScriptEngine* engine = module->GetEngine();
+    as::asIScriptEngine* engine = to->GetEngine();
 
-    bool result = true;
-    for(as::asUINT f = 0, fLen = module->GetImportedFunctionCount(); f < fLen; f++)
+    auto isEnum = [engine](int typeId) -> bool {
+        as::asITypeInfo* type = engine->GetTypeInfoById(typeId);
+
+        return type && (type->GetFlags() & as::asOBJ_ENUM);
+    };
+
+    for(as::asUINT v = 0, vLen = from->GetGlobalVarCount(); v < vLen; v++)
     {
-        const char* importModuleName          = module->GetImportedFunctionSourceModule(f);
-        const char* importFunctionDeclaration = module->GetImportedFunctionDeclaration(f);
-        std::string importString              = "import "s + importFunctionDeclaration + " from \"" + importModuleName + "\"";
+        const char* name       = nullptr;
+        const char* namespace_ = nullptr;
+        int         typeId     = 0;
+        bool        isConst    = false;
 
-        as::asIScriptModule* importModule = engine->GetModule(importModuleName, as::asGM_ONLY_IF_EXISTS);
-        if(!importModule)
-        {
-            WriteError(engine, "Cannot import function (source module does not exists) : "s + importString, module->GetName());
-            result = false;
+        if(from->GetGlobalVar(v, &name, &namespace_, &typeId, &isConst) < 0 || isConst)
             continue;
-        }
 
-        if(UserData::Get(importModule)->Poison)
-        {
-            WriteError(engine, "Cannot import function (source module is poisoned) : "s + importString, module->GetName());
-            result = false;
+        // Declaration includes type, namespace and name
+        const std::string declaration = from->GetGlobalVarDeclaration(v, true);
+        const int         toIndex     = to->GetGlobalVarIndexByDecl(declaration.c_str());
+        if(toIndex < 0)
             continue;
-        }
 
-        as::asIScriptFunction* importFunction = importModule->GetFunctionByDecl(importFunctionDeclaration);
-        if(!importFunction)
+        int toTypeId = 0;
+        to->GetGlobalVar(static_cast<as::asUINT>(toIndex), nullptr, nullptr, &toTypeId);
+
+        // Script classes and enums declared in reloaded module are new types, even if nothing has changed in their code
+        // Declaration already matches, so enums can be copied as plain values as long as their size didn't change
+        const bool sameEnum = isEnum(typeId) && isEnum(toTypeId) && engine->GetSizeOfPrimitiveType(typeId) == engine->GetSizeOfPrimitiveType(toTypeId);
+        if(typeId != toTypeId && !sameEnum)
         {
-            WriteError(engine, "Cannot import function (source function does not exists) : "s + importString, module->GetName());
-            result = false;
+            WriteWarning(engine, "Cannot migrate global variable (type changed) : " + declaration, to->GetName());
             continue;
         }
 
-        if(module->BindImportedFunction(f, importFunction) < 0)
+        void* fromAddress = from->GetAddressOfGlobalVar(v);
+        void* toAddress   = to->GetAddressOfGlobalVar(static_cast<as::asUINT>(toIndex));
+
+        if(typeId & as::asTYPEID_OBJHANDLE)
+        {
+            as::asITypeInfo* type   = engine->GetTypeInfoById(typeId);
+            void*            object = *static_cast<void**>(fromAddress);
+            void*&           handle = *static_cast<void**>(toAddress);
+
+            if(handle)
+                engine->ReleaseScriptObject(handle, type);
+
+            handle = object;
+
+            if(handle)
+                engine->AddRefScriptObject(handle, type);
+        }
+        else if(typeId & as::asTYPEID_MASK_OBJECT)
+            engine->AssignScriptObject(toAddress, fromAddress, engine->GetTypeInfoById(typeId));
+        else
+            std::memcpy(toAddress, fromAddress, static_cast<size_t>(engine->GetSizeOfPrimitiveType(typeId)));
+    }
+}
+
+bool EWAN::Script::LoadLazyModule(as::asIScriptEngine* engine, const std::string& moduleName)
+{
+    auto it = LazyModules.find(moduleName);
+    if(it == LazyModules.end())
+        return engine->GetModule(moduleName.c_str(), as::asGM_ONLY_IF_EXISTS) != nullptr;
+
+    const LazyModule lazy = it->second;
+    LazyModules.erase(it);
+
+    LazyBuilding      = true;
+    const bool loaded = LoadModule(engine, lazy.FileName, lazy.LoadName);
+    LazyBuilding      = false;
+
+    as::asIScriptModule* module = loaded ? engine->GetModule(moduleName.c_str(), as::asGM_ONLY_IF_EXISTS) : nullptr;
+    if(!module || !BindImportedFunctions(module))
+    {
+        if(module)
+            UnloadModule(module);
+
+        WriteError(engine, "Cannot load lazy module", moduleName);
+        return false;
+    }
+
+    // Stubs are still needed to forward calls which triggered loading
+    for(const auto& stub : lazy.Stubs)
+    {
+        BindImportedFunctions(stub.second);
+    }
+
+    // Everyone else can call module functions directly from now on
+    for(as::asUINT m = 0, mLen = engine->GetModuleCount(); m < mLen; m++)
+    {
+        as::asIScriptModule* importer = engine->GetModuleByIndex(m);
+        if(importer == module || UserData::Get(importer)->LazyStub)
+            continue;
+
+        for(as::asUINT f = 0, fLen = importer->GetImportedFunctionCount(); f < fLen; f++)
+        {
+            if(importer->GetImportedFunctionSourceModule(f) == moduleName)
+            {
+                importer->UnbindAllImportedFunctions();
+                BindImportedFunctions(importer);
+
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+void EWAN::Script::LoadLazy_ScriptCall(const std::string& moduleName)
+{
+    as::asIScriptContext* context = as::asGetActiveContext();
+    if(!context)
+        return;
+
+    // Stub would call unbound function otherwise
+    if(!LoadLazyModule(context->GetEngine(), moduleName))
+        context->SetException(("Cannot load lazy module : " + moduleName).c_str());
+}
+
+as::asIScriptFunction* EWAN::Script::GetLazyStub(as::asIScriptEngine* engine, const std::string& moduleName, LazyModule& lazy, const std::string& declaration)
+{
+    auto it = lazy.Stubs.find(declaration);
+    if(it != lazy.Stubs.end())
+        return it->second->GetFunctionByIndex(0);
+
+    const std::string source = GetLazyStubSource(declaration, moduleName);
+    if(source.empty())
+        return nullptr;
+
+    const std::string stubName = moduleName + "~lazy~" + std::to_string(lazy.Stubs.size());
+
+    Builder builder;
+    if(builder.StartNewModule(engine, stubName.c_str()) < 0)
+        return nullptr;
+
+    as::asIScriptModule* module     = builder.GetModule();
+    UserData::Get(module)->LazyStub = true;
+
+    if(builder.AddSectionFromMemory(stubName.c_str(), source.c_str()) < 0 || builder.BuildModule() < 0 || module->GetFunctionCount() != 1)
+    {
+        module->Discard();
+        return nullptr;
+    }
+
+    as::asIScriptFunction* function = module->GetFunctionByIndex(0);
+    function->SetUserData(new UserData::Function, UserData::IDX);
+
+    lazy.Stubs.emplace(declaration, module);
+
+    return function;
+}
+
+bool EWAN::Script::LoadModuleMetadata(Builder& builder)
+{
+    bool result = true;
+
+    as::asIScriptEngine* engine = builder.GetEngine();
+    as::asIScriptModule* module = builder.GetModule();
+
+    // Process "slow" pragmas (requires module to be built first)
+
+    if(UserData::Get(module)->Debug) // #pragma module debug
+    {
+        for(as::asUINT f = 0, fLen = module->GetFunctionCount(); f < fLen; f++)
+        {
+            as::asIScriptFunction* function = module->GetFunctionByIndex(f);
+            UserData::Get(function)->Debug  = true;
+        }
+    }
+
+    // Process functions with metadata
+
+    for(const auto& metadata : builder.GetAllMetadataForFunc())
+    {
+        as::asIScriptFunction* function = engine->GetFunctionById(metadata.first);
+
+        // Check [Debug *] metadata
+        // This should be checked early, as other metadata might want to generate debug messages
+        for(const auto& metadataText : metadata.second)
+        {
+            std::vector<std::string> text = Text::Split(metadataText, ' ');
+
+            if(text.front() == "Debug" && text.size() == 2)
+            {
+                if(text.at(1) == "ON")
+                    UserData::Get(function)->Debug = true;
+                else if(text.at(1) == "OFF")
+                    UserData::Get(function)->Debug = false;
+            }
+        }
+
+        // Check [On*] metadata
+        for(const auto& event : AllEvents)
+        {
+            if(event->Name.substr(0, 2) != "On")
+            {
+                WriteError(engine, "Invalid event name : "s + event->Name);
+                return false;
+            }
+
+            // [OnEvent] or [OnEvent priority=N]
+            auto metadataEvent = std::find_if(metadata.second.begin(), metadata.second.end(), [&event](const std::string& metadataText) -> bool {
+                return Text::Split(metadataText, ' ').front() == event->Name;
+            });
+
+            if(metadataEvent != metadata.second.end())
+            {
+                int32_t priority = 0;
+                bool    valid    = true;
+
+                std::vector<std::string> args = Text::Split(*metadataEvent, ' ');
+                for(auto arg = std::next(args.begin()); arg != args.end(); arg++)
+                {
+                    if(arg->empty())
+                        continue;
+
+                    const std::string value = arg->substr(std::min(arg->size(), sizeof("priority=") - 1));
+                    const auto        r     = std::from_chars(value.data(), value.data() + value.size(), priority);
+
+                    if(arg->rfind("priority=", 0) != 0 || value.empty() || r.ec != std::errc() || r.ptr != value.data() + value.size())
+                    {
+                        WriteError(engine, "Invalid event metadata : [" + *metadataEvent + "]", module->GetName());
+                        valid = false;
+                        break;
+                    }
+                }
+
+                if(!valid)
+                {
+                    result = false;
+                    continue;
+                }
+
+                // This is kind of silly way of validating script function signature, but it works, OK?
+                std::string expectedDeclaration = event->GetDeclaration(function);
+                if(event->Consumable && event->Params.front() == "void" && function->GetReturnTypeId() == as::asTYPEID_BOOL)
+                    expectedDeclaration = "bool" + expectedDeclaration.substr(event->Params.front().size());
+
+                as::asIScriptFunction* sameFunction = module->GetFunctionByDecl(expectedDeclaration.c_str());
+                if(function != sameFunction)
+                {
+                    WriteError(engine, "Invalid function signature for event : " + event->Name + "\nExpected:\n  " + expectedDeclaration + ";\nFound:\n  " + function->GetDeclaration(true, true, false) + ";", module->GetName());
+                    result = false;
+                    continue;
+                }
+
+                event->Register(function, priority);
+            }
+        }
+    }
+
+    return result;
+}
+
+const std::string* EWAN::Script::ReadSource(as::asIScriptModule* module, const std::filesystem::path& fileName)
+{
+    std::error_code error;
+
+    const std::string                     key  = fileName.lexically_normal().make_preferred().string();
+    const std::filesystem::file_time_type time = std::filesystem::last_write_time(key, error);
+
+    if(!error)
+        UserData::Get(module)->Sources[key] = time;
+
+    auto& cache = UserData::Get(module->GetEngine())->SourceCache;
+    auto  it    = cache.find(key);
+
+    if(!error && it != cache.end() && it->second.Time == time)
+        return &it->second.Content;
+
+    UserData::Source source;
+    source.Time = time;
+
+    if(error || !Utils::ReadFile(key, source.Content))
+    {
+        if(it != cache.end())
+            cache.erase(it);
+
+        return nullptr;
+    }
+
+    if(it != cache.end())
+        it->second = std::move(source);
+    else
+        it = cache.emplace(key, std::move(source)).first;
+
+    return &it->second.Content;
+}
+
+/* static */ std::unordered_map<std::string, EWAN::Script::UserData::Source> EWAN::Script::PrefetchSources(const std::string& fileName)
+{
+    std::unordered_map<std::string, UserData::Source> result;
+    std::vector<std::filesystem::path>                queue = {std::filesystem::path(fileName)};
+
+    while(!queue.empty())
+    {
+        const std::string key = queue.back().lexically_normal().make_preferred().string();
+        queue.pop_back();
+
+        if(result.count(key))
+            continue;
+
+        // Time is checked before reading, so file changed in meantime is simply read again by ReadSource()
+        std::error_code  error;
+        UserData::Source source;
+        source.Time = std::filesystem::last_write_time(key, error);
+
+        if(error || !Utils::ReadFile(key, source.Content))
+            continue;
+
+        // Quick scan for `#include "file"` lines; anything missed here is read by include callback anyway
+        std::istringstream stream(source.Content);
+        for(std::string line; std::getline(stream, line);)
+        {
+            line = Text::Trim(line);
+            if(line.rfind("#include", 0) != 0)
+                continue;
+
+            const size_t begin = line.find('"');
+            const size_t end   = line.rfind('"');
+            if(begin != std::string::npos && end > begin)
+                queue.push_back(std::filesystem::path(key).parent_path() / line.substr(begin + 1, end - begin - 1));
+        }
+
+        result.emplace(key, std::move(source));
+    }
+
+    return result;
+}
+
+void EWAN::Script::CommitModules()
+{
+    if(!AS)
+        return;
+
+    for(auto it = PendingModules.begin(); it != PendingModules.end();)
+    {
+        if(it->Sources.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            it++;
+            continue;
+        }
+
+        // Sources are moved into engine cache, LoadModule() reads them from there
+        auto& cache = UserData::Get(AS)->SourceCache;
+        for(auto& source : it->Sources.get())
+        {
+            cache[source.first] = std::move(source.second);
+        }
+
+        const std::string fileName   = it->FileName;
+        const std::string moduleName = it->ModuleName;
+        it                           = PendingModules.erase(it);
+
+        // Module name might be changed by `#pragma module rename`
+        as::asIScriptModule* module = nullptr;
+        if(LoadModule(AS, fileName, moduleName))
+        {
+            for(as::asUINT m = 0, mLen = AS->GetModuleCount(); m < mLen; m++)
+            {
+                as::asIScriptModule*    candidate  = AS->GetModuleByIndex(m);
+                const UserData::Module* moduleData = UserData::Get(candidate);
+
+                if(moduleData->FileName == fileName && moduleData->LoadName == moduleName)
+                    module = candidate;
+            }
+        }
+
+        bool success = module != nullptr;
+        if(module && !BindImportedFunctions(module))
+        {
+            UnloadModule(module);
+            success = false;
+        }
+
+        OnModuleLoaded.Run(moduleName, success);
+    }
+}
+
+//
+
+std::string EWAN::Script::GetContextFunctionDetails(as::asIScriptContext* context, as::asUINT stackLevel /*= 0 */)
+{
+    int         line, column;
+    const char* sectionName;
+
+    line                            = context->GetLineNumber(stackLevel, &column, &sectionName);
+    as::asIScriptFunction* function = context->GetFunction(stackLevel);
+
+    std::string details;
+    details += " "s + function->GetModuleName();
+    details += " "s + sectionName;
+    details += " "s + function->GetDeclaration(true, true, false);
+    details += " "s + std::to_string(line) + "," + std::to_string(column);
+
+    return details.substr(1);
+}
+
+//
+
+std::string EWAN::Script::CurrentEventName_ScriptCall()
+{
+    as::asIScriptContext* context = as::asGetActiveContext();
+    if(!context)
+        return {};
+
+    return UserData::Get(context)->Event->Name;
+}
+
+void EWAN::Script::Yield_ScriptCall()
+{
+    as::asIScriptContext* context = as::asGetActiveContext();
+    if(!context)
+        return;
+
+    UserData::Get(context)->SuspendReason = SuspendReason::Yield;
+    context->Suspend();
+}
+
+//
+
+uint32_t EWAN::Script::Spawn_ScriptCall(const std::string& fileName, const std::string& function, const std::string& data)
+{
+    as::asIScriptContext* context = as::asGetActiveContext();
+    if(!context)
+        return 0;
+    else if(Text::IsBlank(fileName) || Text::IsBlank(function))
+    {
+        WriteError(context->GetEngine(), "Spawn : fileName or function is blank");
+        return 0;
+    }
+
+    return Workers.Spawn(RootDirectory + fileName, function, data);
+}
+
+//
+
+std::vector<EWAN::Script::StatsInfo> EWAN::Script::GetStats() const
+{
+    std::vector<StatsInfo> result;
+
+    for(const auto& event : AllEvents)
+    {
+        for(const auto& function : event->GetFunctions())
+        {
+            result.push_back({event->Name, function->GetModuleName(), function->GetDeclaration(true, true, false), UserData::Get(function)->Stats});
+        }
+    }
+
+    return result;
+}
+
+void EWAN::Script::LogStats() const
+{
+    if(!AS)
+        return;
+
+    for(const auto& info : GetStats())
+    {
+        if(!info.Stats.Calls)
+            continue;
+
+        WriteInfo(AS, info.Event + " : " + info.Function + " : calls=" + std::to_string(info.Stats.Calls) + " yields=" + std::to_string(info.Stats.Yields) + " total=" + std::to_string(info.Stats.TimeTotal) + "us mean=" + std::to_string(info.Stats.GetTimeMean()) + "us max=" + std::to_string(info.Stats.TimeMax) + "us p99=" + std::to_string(info.Stats.GetTimeP99()) + "us", info.Module);
+    }
+
+    WriteInfo(AS, "Garbage : alive=" + std::to_string(Garbage.Alive) + " destroyed=" + std::to_string(Garbage.Destroyed) + " detected=" + std::to_string(Garbage.Detected) + " total=" + std::to_string(Garbage.TimeTotal) + "us max=" + std::to_string(Garbage.TimeMax) + "us");
+}
+
+EWAN::Script::UserData::FunctionStats* EWAN::Script::GetStats_ScriptCall(const std::string& moduleName, const std::string& functionDeclaration)
+{
+    as::asIScriptContext* context = as::asGetActiveContext();
+    if(!context)
+        return nullptr;
+
+    as::asIScriptModule* module = context->GetEngine()->GetModule(moduleName.c_str(), as::asGM_ONLY_IF_EXISTS);
+    if(!module)
+        return nullptr;
+
+    as::asIScriptFunction* function = module->GetFunctionByDecl(functionDeclaration.c_str());
+    if(!function)
+        return nullptr;
+
+    return &UserData::Get(function)->Stats;
+}
+
+float EWAN::Script::GetStatsInterval_ScriptCall() const
+{
+    return StatsInterval;
+}
+
+void EWAN::Script::SetStatsInterval_ScriptCall(float interval)
+{
+    StatsInterval = std::max(interval, 0.0f);
+    StatsTime     = std::chrono::steady_clock::now();
+}
+
+uint32_t EWAN::Script::GetGarbageBudget_ScriptCall() const
+{
+    return GarbageBudget;
+}
+
+void EWAN::Script::SetGarbageBudget_ScriptCall(uint32_t budget)
+{
+    GarbageBudget = budget;
+}
+
+float EWAN::Script::GetReloadInterval_ScriptCall() const
+{
+    return ReloadInterval;
+}
+
+void EWAN::Script::SetReloadInterval_ScriptCall(float interval)
+{
+    ReloadInterval = std::max(interval, 0.0f);
+    ReloadTime     = std::chrono::steady_clock::now();
+}
+
+bool EWAN::Script::GetDebugContexts_ScriptCall() const
+{
+    return DebugContexts;
+}
+
+void EWAN::Script::SetDebugContexts_ScriptCall(bool enabled)
+{
+    // Contexts already running keeps their state; change affects only next requested context
+    DebugContexts = enabled;
+}
+
+//
+
+bool EWAN::Script::BindImportedFunctions(as::asIScriptEngine* engine)
+{
+    for(as::asUINT m = 0, mLen = engine->GetModuleCount(); m < mLen; m++)
+    {
+        as::asIScriptModule* module = engine->GetModuleByIndex(m);
+
+        // Lazy stubs are bound by LoadLazyModule()
+        if(UserData::Get(module)->LazyStub)
+            continue;
+
+        if(!BindImportedFunctions(module))
+            return false;
+    }
+
+    return true;
+}
+
+bool EWAN::Script::BindImportedFunctions(as::asIScriptModule* module)
+{
+    as::asIScriptEngine* engine = module->GetEngine();
+
+    bool result = true;
+    for(as::asUINT f = 0, fLen = module->GetImportedFunctionCount(); f < fLen; f++)
+    {
+        const char* importModuleName          = module->GetImportedFunctionSourceModule(f);
+        const char* importFunctionDeclaration = module->GetImportedFunctionDeclaration(f);
+        std::string importString              = "import "s + importFunctionDeclaration + " from \"" + importModuleName + "\"";
+
+        as::asIScriptModule* importModule = engine->GetModule(importModuleName, as::asGM_ONLY_IF_EXISTS);
+        if(!importModule && LazyModules.count(importModuleName))
+        {
+            // AngelScript checks only function signature when binding, so stub can have any name
+            as::asIScriptFunction* stub = GetLazyStub(engine, importModuleName, LazyModules.at(importModuleName), importFunctionDeclaration);
+            if(!stub || module->BindImportedFunction(f, stub) < 0)
+            {
+                WriteError(engine, "Cannot import function (lazy stub failed) : "s + importString, module->GetName());
+                result = false;
+            }
+
+            continue;
+        }
+        else if(!importModule)
+        {
+            WriteError(engine, "Cannot import function (source module does not exists) : "s + importString, module->GetName());
+            result = false;
+            continue;
+        }
+
+        if(UserData::Get(importModule)->Poison)
+        {
+            WriteError(engine, "Cannot import function (source module is poisoned) : "s + importString, module->GetName());
+            result = false;
+            continue;
+        }
+
+        as::asIScriptFunction* importFunction = importModule->GetFunctionByDecl(importFunctionDeclaration);
+        if(!importFunction)
+        {
+            WriteError(engine, "Cannot import function (source function does not exists) : "s + importString, module->GetName());
+            result = false;
+            continue;
+        }
+
+        if(module->BindImportedFunction(f, importFunction) < 0)
         {
             WriteError(engine, "Cannot import function : "s + importString, module->GetName());
             result = false;
@@ -547,11 +1424,23 @@ bool EWAN::Script::BindImportedFunctions(as::asIScriptModule* module)
 
 as::asIScriptEngine* EWAN::Script::CreateEngine()
 {
+    // Pooled allocator must be installed before first engine is created
+    if(!Memory::Init())
+        Log::PrintWarning("Cannot install script memory functions, using default allocator");
+
+    // Workers create their own engines in other threads, which requires thread manager to be set up by main thread first
+    if(as::asPrepareMultithread() < 0)
+    {
+        Log::PrintError("Cannot prepare script engine for multithreading");
+        return nullptr;
+    }
+
     as::asIScriptEngine* engine = as::asCreateScriptEngine();
     if(!engine)
+    {
+        as::asUnprepareMultithread();
         return nullptr;
-
-    int r;
+    }
 
     if(!API::InitEngineCallback(this, engine))
     {
@@ -561,24 +1450,12 @@ as::asIScriptEngine* EWAN::Script::CreateEngine()
         return nullptr;
     }
 
-    static const std::unordered_map<as::asEEngineProp, as::asPWORD> properties = {
-        {as::asEP_COMPILER_WARNINGS, 2}, // -Werror for scripts, woohoo!
-        {as::asEP_DISALLOW_EMPTY_LIST_ELEMENTS, true},
-        {as::asEP_OPTIMIZE_BYTECODE, true},
-        {as::asEP_REQUIRE_ENUM_SCOPE, true}
-        //
-    };
-
-    for(const auto& property : properties)
+    // Garbage is collected incrementally by main loop, see GarbageCollect()
+    if(!SetEngineProperties(engine) || engine->SetEngineProperty(as::asEP_AUTO_GARBAGE_COLLECT, false) < 0)
     {
-        r = engine->SetEngineProperty(property.first, property.second);
-        if(r < 0)
-        {
-            WriteError(engine, "Cannot set script engine property : " + std::to_string(property.first) + " = " + std::to_string(property.second));
-            DestroyEngine(engine);
+        DestroyEngine(engine);
 
-            return nullptr;
-        }
+        return nullptr;
     }
 
     engine->SetContextCallbacks(Callback::ContextRequest, Callback::ContextReturn, nullptr);
@@ -611,51 +1488,60 @@ void EWAN::Script::DestroyEngine(as::asIScriptEngine*& engine)
     // Context cache must be cleared manually before shutting down script engine
     // Without that user data cleanup callback won't be called, thanks to reference counting
     UserData::Engine* engineData = UserData::Get(engine);
-    if(!engineData->ContextCache.empty())
+    for(auto& contextCache : {&engineData->ContextCache, &engineData->ContextCacheDebug})
     {
-        for(auto& context : engineData->ContextCache)
+        for(auto& context : *contextCache)
         {
             context->Release();
         }
-        engineData->ContextCache.clear();
+        contextCache->clear();
     }
 
     engine->ShutDownAndRelease();
     engine = nullptr;
-}
 
-//
+    // Workers are expected to be finished at this point
+    as::asUnprepareMultithread();
+}
 
-void EWAN::Script::CallbackContextLine([[maybe_unused]] as::asIScriptContext* context)
+/* static */ bool EWAN::Script::SetEngineProperties(as::asIScriptEngine* engine)
 {
-    // Need explicit user data check here, as callback is also used by internal functions which doesn't have user data set
-    UserData::Function* functionData = UserData::Get(context->GetFunction());
+    static const std::unordered_map<as::asEEngineProp, as::asPWORD> properties = {
+        {as::asEP_COMPILER_WARNINGS, 2}, // -Werror for scripts, woohoo!
+        {as::asEP_DISALLOW_EMPTY_LIST_ELEMENTS, true},
+        {as::asEP_OPTIMIZE_BYTECODE, true},
+        {as::asEP_REQUIRE_ENUM_SCOPE, true}
+        //
+    };
 
-    if(functionData && functionData->Debug)
+    for(const auto& property : properties)
     {
-#if 0
-        std::string text = "?";
-        as::asIScriptFunction* systemFunction = context->GetSystemFunction();
-        if(systemFunction)
-            text = "! "s + systemFunction->GetDeclaration(true, true, true);
-
-        WriteInfo(context->GetEngine(), text, GetContextFunctionDetails(context));
-#endif
+        if(engine->SetEngineProperty(property.first, property.second) < 0)
+        {
+            WriteError(engine, "Cannot set script engine property : " + std::to_string(property.first) + " = " + std::to_string(property.second));
+            return false;
+        }
     }
+
+    return true;
 }
 
-as::asIScriptContext* EWAN::Script::CallbackContextRequest(as::asIScriptEngine* engine, [[maybe_unused]] void* data)
+//
+
+as::asIScriptContext* EWAN::Script::RequestContext(as::asIScriptEngine* engine, bool debug, as::asIScriptFunction* function /*= nullptr */)
 {
-    as::asIScriptContext* context    = nullptr;
-    UserData::Engine*     engineData = UserData::Get(engine);
+    as::asIScriptContext*               context      = nullptr;
+    UserData::Engine*                   engineData   = UserData::Get(engine);
+    std::vector<as::asIScriptContext*>& contextCache = debug ? engineData->ContextCacheDebug : engineData->ContextCache;
 
-    if(engineData->ContextCache.empty())
+    if(contextCache.empty())
     {
         // WriteInfo(engine, "Creating script context");
 
         context = engine->CreateContext();
 
-        if(!API::InitContextCallback(this, context))
+        // Line callback forces AngelScript to check for it on every executed line, plain contexts skips that completely
+        if(debug && !API::InitContextCallback(this, context))
         {
             WriteError(engine, "Cannot set script context line callback");
             context->Release();
@@ -663,25 +1549,89 @@ as::asIScriptContext* EWAN::Script::CallbackContextRequest(as::asIScriptEngine*
         }
 
         context->SetUserData(new UserData::Context, UserData::IDX);
+        UserData::Get(context)->Debug = debug;
+
+        return context;
     }
-    else
+
+    // Move context bound to function (if any) to top of stack; search starts from top, where recently used contexts are
+    if(function)
     {
-        context = engineData->ContextCache.front();
-        engineData->ContextCache.pop_front();
+        auto it = std::find_if(contextCache.rbegin(), contextCache.rend(), [function](as::asIScriptContext* cached) -> bool {
+            return cached->GetFunction() == function;
+        });
+
+        if(it != contextCache.rend())
+            std::iter_swap(it, contextCache.rbegin());
     }
 
+    context = contextCache.back();
+    contextCache.pop_back();
+
     return context;
 }
 
+void EWAN::Script::UnbindContexts(as::asIScriptModule* module)
+{
+    UserData::Engine* engineData = UserData::Get(module->GetEngine());
+
+    for(auto& contextCache : {&engineData->ContextCache, &engineData->ContextCacheDebug})
+    {
+        for(auto& context : *contextCache)
+        {
+            as::asIScriptFunction* function = context->GetFunction();
+            if(function && function->GetModule() == module)
+                context->Unprepare();
+        }
+    }
+}
+
+bool EWAN::Script::IsDebugFunction(as::asIScriptFunction* function) const
+{
+    if(!DebugContexts)
+        return false;
+
+    UserData::Function* functionData = UserData::Get(function);
+
+    return functionData && functionData->Debug;
+}
+
+void EWAN::Script::CallbackContextLine([[maybe_unused]] as::asIScriptContext* context)
+{
+    // Need explicit user data check here, as callback is also used by internal functions which doesn't have user data set
+    UserData::Function* functionData = UserData::Get(context->GetFunction());
+
+    if(functionData && functionData->Debug)
+    {
+#if 0
+        std::string text = "?";
+        as::asIScriptFunction* systemFunction = context->GetSystemFunction();
+        if(systemFunction)
+            text = "! "s + systemFunction->GetDeclaration(true, true, true);
+
+        WriteInfo(context->GetEngine(), text, GetContextFunctionDetails(context));
+#endif
+    }
+}
+
+as::asIScriptContext* EWAN::Script::CallbackContextRequest(as::asIScriptEngine* engine, [[maybe_unused]] void* data)
+{
+    // Contexts requested by AngelScript itself or addons are never instrumented
+    return RequestContext(engine, false);
+}
+
 void EWAN::Script::CallbackContextReturn([[maybe_unused]] as::asIScriptEngine* engine, as::asIScriptContext* context, [[maybe_unused]] void* data)
 {
     UserData::Engine*  engineData  = UserData::Get(engine);
     UserData::Context* contextData = UserData::Get(context);
 
+    // Context which finished event callback stays prepared, next Prepare() for same function takes fast path in AngelScript
+    if(!contextData->Function || context->GetState() != as::asEXECUTION_FINISHED)
+        context->Unprepare();
+
     contextData->Reset();
-    context->Unprepare();
 
-    engineData->ContextCache.push_back(context);
+    (contextData->Debug ? engineData->ContextCacheDebug : engineData->ContextCache).push_back(context);
 
     // WriteInfo(engine, "Caching script context : " + std::to_string(engineData->ContextCache.size()) + " total");
 }
@@ -705,17 +1655,27 @@ int EWAN::Script::CallbackInclude(Builder& builder, const std::string& include,
 
     std::string sectionName = Text::Replace(std::filesystem::relative(fileName, RootDirectory).make_preferred().string(), "\\", "/");
 
-    std::string fileContent;
-    if(!Utils::ReadFile(fileName.make_preferred().string(), fileContent))
+    const auto         start       = std::chrono::steady_clock::now();
+    const std::string* fileContent = ReadSource(builder.GetModule(), fileName);
+
+    // Include callback is called from inside AddSectionFromMemory(), LoadModule() subtracts that time from preprocessing
+    UserData::Get(builder.GetModule())->TimeRead += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    if(!fileContent)
         return -1;
 
-    if(builder.AddSectionFromMemory(sectionName.c_str(), fileContent.c_str()) < 0)
+    if(builder.AddSectionFromMemory(sectionName.c_str(), fileContent->c_str()) < 0)
         return -1;
 
     return 0;
 }
 
 void EWAN::Script::CallbackMessage(const as::asSMessageInfo& msg)
+{
+    LogMessage(msg);
+}
+
+/* static */ void EWAN::Script::LogMessage(const as::asSMessageInfo& msg)
 {
     static const std::function<void(const std::string&)> functions[3] = {&Log::PrintError, &Log::PrintWarning, &Log::PrintInfo};
     std::function<void(const std::string&)>              function     = functions[msg.type];
@@ -811,6 +1771,26 @@ int EWAN::Script::CallbackPragma(Builder& builder, const std::string& pragmaText
             WriteInfo(engine, "Rename module : "s + pragmargs.front(), module->GetName());
             module->SetName(pragmargs.front().c_str());
         }
+        else if(pragma == "lazy" && pragmargs.empty())
+        {
+            // Module is built on first call of any function imported from it, or by Script.LoadLazy(); until then, its event callbacks are not registered
+            UserData::Module* moduleData = UserData::Get(module);
+            if(!moduleData->Lazy)
+            {
+                moduleData->Lazy = true;
+                WriteInfo(engine, "Module setup : lazy", module->GetName());
+            }
+        }
+        else if(pragma == "worker" && pragmargs.empty())
+        {
+            // Allows module to be used by Script.Spawn(), has no effect on main thread
+            UserData::Module* moduleData = UserData::Get(module);
+            if(!moduleData->Worker)
+            {
+                moduleData->Worker = true;
+                WriteInfo(engine, "Module setup : worker", module->GetName());
+            }
+        }
         else if(pragma == "unload" && pragmargs.empty())
         {
             UserData::Module* moduleData = UserData::Get(module);
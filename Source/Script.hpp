@@ -4,13 +4,25 @@
 
 #include "Libs/AngelScript.hpp"
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
 #include <functional>
+#include <future>
 #include <list>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <utility> // std::forward
+#include <vector>
 
 namespace EWAN
 {
@@ -31,12 +43,18 @@ namespace EWAN
             static bool Init(App* app, as::asIScriptEngine* engine, const std::string& namespace_);
             static bool InitEngineCallback(Script* script, as::asIScriptEngine* engine);
             static bool InitContextCallback(Script* script, as::asIScriptContext* context);
+            static bool InitWorker(as::asIScriptEngine* engine, const std::string& namespace_);
 
         protected:
             static void AppLog(App*, std::string text);
+            static void WorkerLog(void*, std::string text);
 
         private:
             static int RegisterContentCache(as::asIScriptEngine* engine, const std::string& type, const std::string& subtype = {});
+            static int RegisterMath(as::asIScriptEngine* engine);
+
+            template<typename T>
+            static int RegisterVector(as::asIScriptEngine* engine, const std::string& type);
         };
 
         class Builder : public as::CScriptBuilder
@@ -76,8 +94,16 @@ namespace EWAN
 
             bool IgnoreExecuteErrors = false;
 
+            // Allows `void` event callbacks to return `bool` instead; returning true stops event propagation
+            bool Consumable = false;
+
+            // Set by Run(), true if any callback has consumed event during last run
+            bool Consumed = false;
+
         protected:
-            std::list<as::asIScriptFunction*> Functions;
+            // Sorted by priority (highest first) at registration time, callbacks with same priority are kept in registration order
+            std::list<as::asIScriptFunction*>                   Functions;
+            std::unordered_map<as::asIScriptFunction*, int32_t> Priorities;
 
             static std::function<void(as::asIScriptContext*)> NOP;
 
@@ -92,14 +118,21 @@ namespace EWAN
             std::string GetDeclaration(const std::string& name = "f") const;
             std::string GetDeclaration(as::asIScriptFunction* function) const;
 
+            const std::list<as::asIScriptFunction*>& GetFunctions() const;
+
         public:
-            void Register(as::asIScriptFunction* function);
+            void Register(as::asIScriptFunction* function, int32_t priority = 0);
             void Unregister(as::asIScriptEngine* engine);
             void Unregister(as::asIScriptModule* module);
 
             bool Run();
             bool Run(const int32_t& arg0);
+            bool Run(const float& arg0);
             bool Run(const int32_t& arg0, const int32_t& arg1);
+            bool Run(const uint32_t& arg0, const bool& arg1, const std::string& arg2);
+            bool Run(const std::string& arg0);
+            bool Run(const std::string& arg0, const bool& arg1);
+            bool Run(void* arg0); // handle
             bool RunBool(bool& result);
 
         protected:
@@ -111,41 +144,186 @@ namespace EWAN
             bool RunOnInit(as::asIScriptEngine* engine, as::asIScriptFunction*& function);
         };
 
+        // Pooled memory allocator used by all script engines
+        //
+        // Small allocations are served from size-class pools, anything bigger goes directly to malloc()
+        // Installed once, before first engine is created; pools are never released, as they're reused after App restart
+        class Memory
+        {
+        public:
+            struct Stats
+            {
+                uint64_t Allocations = 0;
+                uint64_t Frees       = 0;
+                uint64_t Bytes       = 0; // currently allocated by scripts
+                uint64_t PoolBytes   = 0; // reserved by pools
+
+                uint32_t FrameAllocations = 0;
+                uint32_t FrameFrees       = 0;
+                uint64_t FrameBytes       = 0;
+            };
+
+        public:
+            static bool Init();
+
+            static void* Alloc(size_t size);
+            static void  Free(void* memory);
+
+            // Returns current statistics; frame counters are reset on each call
+            static Stats NewFrame();
+        };
+
+        // Runs script functions on background threads
+        //
+        // Every thread owns a separate script engine, with minimal API and no access to App;
+        // only strings are passed between threads, so worker scripts cannot touch main thread script state
+        //
+        // Scripts executed by workers must be marked with `#pragma module worker`,
+        // and functions must use `string f(const string&in data)` signature
+        class Worker
+        {
+        public:
+            struct Job
+            {
+                uint32_t    ID = 0;
+                std::string FileName;
+                std::string Function;
+                std::string Data; // input when queued, result when finished
+
+                bool Success = false;
+            };
+
+        protected:
+            std::vector<std::thread>           Threads;
+            std::vector<as::asIScriptContext*> Contexts; // one per thread, aborted by Finish()
+            std::deque<Job>                    Queue;
+            std::deque<Job>                    Finished;
+            std::mutex                         QueueLock;
+            std::condition_variable            QueueSignal;
+
+            std::string Namespace;
+            uint32_t    LastID   = 0;
+            bool        Stopping = false;
+
+        public:
+            Worker();
+            virtual ~Worker();
+
+        public:
+            void Init(const std::string& namespace_);
+            void Finish();
+
+            // Queues new job, starting threads if needed
+            // Returns job id, or zero on error
+            uint32_t Spawn(const std::string& fileName, const std::string& function, const std::string& data);
+
+            // Moves one finished job to `job`
+            // Returns false if there's no finished jobs
+            bool Collect(Job& job);
+
+        protected:
+            void ThreadMain();
+
+            bool Execute(as::asIScriptEngine* engine, as::asIScriptContext* context, std::map<std::string, std::filesystem::file_time_type>& sources, Job& job);
+
+            static as::asIScriptEngine* CreateEngine(const std::string& namespace_);
+            static as::asIScriptModule* LoadModule(as::asIScriptEngine* engine, const std::string& fileName, std::map<std::string, std::filesystem::file_time_type>& sources);
+        };
+
         class UserData
         {
         public:
             struct Context
             {
                 EWAN::Script::Event*        Event         = nullptr;
+                as::asIScriptFunction*      Function      = nullptr; // event callback, not current function
                 EWAN::Script::SuspendReason SuspendReason = EWAN::Script::SuspendReason::Unknown;
 
+                // Set when context has line callback installed; never changes after creation
+                bool Debug = false;
+
                 void Reset()
                 {
                     Event         = nullptr;
+                    Function      = nullptr;
                     SuspendReason = EWAN::Script::SuspendReason::Unknown;
                 }
             };
 
+            // Script file content, as returned by Utils::ReadFile()
+            struct Source
+            {
+                std::filesystem::file_time_type Time;
+                std::string                     Content;
+            };
+
             struct Engine
             {
-                EWAN::Script*                    Script = nullptr;
-                std::list<as::asIScriptContext*> ContextCache;
+                EWAN::Script* Script = nullptr;
+
+                // Free contexts, used as stacks; contexts which finished event callback are kept prepared for it
+                std::vector<as::asIScriptContext*> ContextCache;
+                std::vector<as::asIScriptContext*> ContextCacheDebug; // contexts with line callback
+
+                // Key is normalized file path; entry is reused as long as file modification time does not change
+                std::unordered_map<std::string, Source> SourceCache;
+            };
+
+            // Execution statistics, updated by Event::Run()
+            // All times are in microseconds; max/percentiles are calculated from single Execute() calls, mean from whole event calls
+            struct FunctionStats
+            {
+                static constexpr size_t SamplesSize = 256;
+
+                uint32_t Calls  = 0;
+                uint32_t Yields = 0;
+
+                int64_t TimeTotal = 0;
+                int64_t TimeMax   = 0;
+
+                std::array<int64_t, SamplesSize> Samples {};
+                size_t                           SamplesCount = 0;
+
+                void Record(int64_t time);
+                void Reset();
+
+                int64_t GetTimeMean() const;
+                int64_t GetTimePercentile(uint8_t percentile) const;
+                int64_t GetTimeP99() const;
             };
 
             struct Function
             {
                 bool Debug     = false;
                 bool DebugLine = false;
+
+                FunctionStats Stats;
             };
 
             struct Module
             {
                 bool Debug    = false;
+                bool Lazy     = false;
                 bool Optional = false;
                 bool Poison   = false;
                 bool Unload   = false;
-
-                bool Import = false;
+                bool Worker   = false;
+
+                bool Import   = false;
+                bool LazyStub = false; // generated by GetLazyStub()
+
+                // Used by ReloadModule(); FileName and LoadName are arguments passed to LoadModule()
+                // Sources holds all files used to build module (including itself), and their modification time at that moment
+                std::string                                            FileName;
+                std::string                                            LoadName;
+                std::map<std::string, std::filesystem::file_time_type> Sources;
+
+                // Module loading times, in microseconds
+                // Reading included files is counted as TimeRead, not TimePreprocess
+                int64_t TimeRead       = 0;
+                int64_t TimePreprocess = 0;
+                int64_t TimeBuild      = 0;
+                int64_t TimeMetadata   = 0;
             };
 
         public:
@@ -157,6 +335,48 @@ namespace EWAN
             static Module*   Get(as::asIScriptModule* module);
         };
 
+        // Single entry returned by GetStats()
+        struct StatsInfo
+        {
+            std::string Event;
+            std::string Module;
+            std::string Function;
+
+            UserData::FunctionStats Stats;
+        };
+
+        // Garbage collector state, updated by GarbageCollect()
+        struct GarbageStats
+        {
+            uint32_t Alive     = 0; // objects currently known to collector
+            uint32_t Destroyed = 0; // total
+            uint32_t Detected  = 0; // total, objects with circular references
+
+            uint32_t FrameSteps = 0;
+            int64_t  FrameTime  = 0; // microseconds
+            int64_t  TimeTotal  = 0; // microseconds
+            int64_t  TimeMax    = 0; // microseconds, single frame
+        };
+
+        // Module requested by LoadModuleAsync(), waiting for its sources to be read in background
+        struct PendingModule
+        {
+            std::string FileName;
+            std::string ModuleName;
+
+            std::future<std::unordered_map<std::string, UserData::Source>> Sources;
+        };
+
+        // Module marked with `#pragma module lazy`, waiting for first call of any function imported from it
+        struct LazyModule
+        {
+            std::string FileName;
+            std::string LoadName;
+
+            // Key is imported function declaration
+            std::map<std::string, as::asIScriptModule*> Stubs;
+        };
+
         //
 
     public:
@@ -169,17 +389,54 @@ namespace EWAN
 
         Event OnFinish;
         Event OnDraw;
+        Event OnDrawLayer;
+        Event OnUpdate;
         Event OnKeyDown;
         Event OnKeyUp;
         Event OnMouseDown;
         Event OnMouseUp;
         Event OnMouseMove;
+        Event OnInputFrame;
+        Event OnJob;
+        Event OnModuleLoaded;
+
+        Worker Workers;
+
+        // Interval (in seconds) of event statistics dump, disabled when zero
+        float StatsInterval = 0.0f;
+
+        // Updated once per frame; frame counters holds data from previous frame
+        Memory::Stats MemoryStats;
+
+        // Time (in microseconds) which can be spent on incremental garbage collection every frame
+        // At least one step is always done, so collector keeps moving even when budget is zero
+        uint32_t     GarbageBudget = 1000;
+        GarbageStats Garbage;
+
+        // Interval (in seconds) of checking if any module sources has been changed, disabled when zero
+        float ReloadInterval = 0.0f;
+
+        // Amount of plain contexts created during Init(), before any module is loaded
+        uint32_t ContextPoolSize = 8;
+
+        // Functions marked with [Debug ON] or `#pragma module debug` runs in contexts with line callback installed,
+        // all other functions runs in plain contexts; when disabled, plain contexts are used for everything
+        bool DebugContexts = true;
 
     private:
         std::vector<Event*>  AllEvents;
         std::string          RootDirectory;
         as::asIScriptEngine* AS = nullptr;
 
+        std::chrono::steady_clock::time_point StatsTime;
+        std::chrono::steady_clock::time_point ReloadTime;
+        bool                                  ReloadRequested = false;
+
+        std::list<PendingModule> PendingModules;
+
+        std::map<std::string, LazyModule> LazyModules;
+        bool                              LazyBuilding = false;
+
     public:
         Script();
         virtual ~Script();
@@ -188,29 +445,90 @@ namespace EWAN
         bool Init(App* app);
         void Finish();
 
+        // Called once per frame by App::MainLoop()
+        void Update();
+        void GarbageCollect(uint32_t budget);
+
+        static void LogMessage(const as::asSMessageInfo& msg);
         static void WriteInfo(as::asIScriptEngine* engine, const std::string& message, const std::string& section = {}, int row = 0, int col = 0);
         static void WriteWarning(as::asIScriptEngine* engine, const std::string& message, const std::string& section = {}, int row = 0, int col = 0);
         static void WriteError(as::asIScriptEngine* engine, const std::string& message, const std::string& section = {}, int row = 0, int col = 0);
 
         bool LoadModule(as::asIScriptEngine* engine, const std::string& fileName, const std::string& moduleName);
         bool LoadModule_ScriptCall(const std::string& fileName, const std::string& moduleName);
+        bool LoadModuleAsync_ScriptCall(const std::string& fileName, const std::string& moduleName);
         bool LoadInitModule(const GameInfo& game, as::asIScriptEngine* engine);
         bool UnloadModule(as::asIScriptModule*& module);
         bool UnloadModule_ScriptCall(const std::string& moduleName);
 
+        // Rebuilds module from its (changed) sources, keeping values of global variables and without running [OnInit]
+        // Modules importing functions from reloaded module are rebound to new version
+        bool     ReloadModule(as::asIScriptModule*& module);
+        uint32_t ReloadModules();
+        void     Reload_ScriptCall();
+
+        static bool IsModuleChanged(as::asIScriptModule* module);
+        static void MigrateGlobalVariables(as::asIScriptModule* from, as::asIScriptModule* to);
+
+        // Lazy modules are preprocessed by LoadModule(), but built only when one of functions imported from them is called for first time
+        // Until then, imports are bound to stub functions which loads module and forwards call
+        bool                   LoadLazyModule(as::asIScriptEngine* engine, const std::string& moduleName);
+        void                   LoadLazy_ScriptCall(const std::string& moduleName);
+        as::asIScriptFunction* GetLazyStub(as::asIScriptEngine* engine, const std::string& moduleName, LazyModule& lazy, const std::string& declaration);
+
         bool LoadModuleMetadata(Builder& builder);
 
+        // Returns cached content of script file, or nullptr if file cannot be read
+        // File is added to module sources list
+        const std::string* ReadSource(as::asIScriptModule* module, const std::filesystem::path& fileName);
+
+        // Reads file and everything it includes; safe to call from any thread
+        static std::unordered_map<std::string, UserData::Source> PrefetchSources(const std::string& fileName);
+
+        // Builds modules requested by LoadModuleAsync() which sources are ready
+        void CommitModules();
+
         std::string GetContextFunctionDetails(as::asIScriptContext* context, as::asUINT stackLevel = 0);
 
         std::string CurrentEventName_ScriptCall();
         void        Yield_ScriptCall();
 
+        // Returns statistics of all registered event callbacks
+        std::vector<StatsInfo> GetStats() const;
+        void                   LogStats() const;
+
+        uint32_t Spawn_ScriptCall(const std::string& fileName, const std::string& function, const std::string& data);
+
+        UserData::FunctionStats* GetStats_ScriptCall(const std::string& moduleName, const std::string& functionDeclaration);
+        float                      GetStatsInterval_ScriptCall() const;
+        void                       SetStatsInterval_ScriptCall(float interval);
+        uint32_t                   GetGarbageBudget_ScriptCall() const;
+        void                       SetGarbageBudget_ScriptCall(uint32_t budget);
+        float                      GetReloadInterval_ScriptCall() const;
+        void                       SetReloadInterval_ScriptCall(float interval);
+        bool                       GetDebugContexts_ScriptCall() const;
+        void                       SetDebugContexts_ScriptCall(bool enabled);
+
     protected:
         bool                 BindImportedFunctions(as::asIScriptEngine* engine);
         bool                 BindImportedFunctions(as::asIScriptModule* module);
         as::asIScriptEngine* CreateEngine();
         void                 DestroyEngine(as::asIScriptEngine*& engine);
 
+        static bool SetEngineProperties(as::asIScriptEngine* engine);
+
+    public:
+        // Returns context from pool matching requested kind, creating new one if needed
+        // If function is set, context which has been used to run it previously is preferred, as it's still prepared for it
+        // Contexts are returned to pool with engine->ReturnContext()
+        as::asIScriptContext* RequestContext(as::asIScriptEngine* engine, bool debug, as::asIScriptFunction* function = nullptr);
+
+        // Unprepares pooled contexts still prepared for any of module functions
+        void UnbindContexts(as::asIScriptModule* module);
+
+        // Returns true if function should be executed in context with line callback
+        bool IsDebugFunction(as::asIScriptFunction* function) const;
+
     public:
         void                  CallbackContextLine(as::asIScriptContext* context);
         as::asIScriptContext* CallbackContextRequest(as::asIScriptEngine* engine, void* data);
@@ -220,32 +538,56 @@ namespace EWAN
         int                   CallbackPragma(Builder& builder, const std::string& pragmaText, void* data);
 
     public:
+        // Script arrays keep primitives and handles in single buffer, while objects are allocated separately and only pointers are stored
+        // Contiguous elements are copied in bulk (memcpy() for vectors), handles are AddRef'd in separate pass; objects are copied one by one
         template<typename C, typename T>
-        void AppendStdContainerToArray(const C& container, as::CScriptArray* arr, bool addRef)
+        static void AppendStdContainerToArray(const C& container, as::CScriptArray* arr, bool addRef)
         {
-            if(!container.empty() && arr)
+            if(container.empty() || !arr)
+                return;
+
+            const as::asUINT current = arr->GetSize();
+            arr->Resize(static_cast<as::asUINT>(current + container.size()));
+
+            if constexpr(std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>)
             {
-                as::asUINT current = arr->GetSize();
-                arr->Resize(static_cast<as::asUINT>(current + container.size()));
+                T* arrayObject = static_cast<T*>(arr->At(current));
+
+                if constexpr(std::is_same_v<C, std::vector<T>>)
+                    std::memcpy(static_cast<void*>(arrayObject), container.data(), container.size() * sizeof(T));
+                else
+                    std::copy(container.begin(), container.end(), arrayObject);
 
-                for(T containerObject : container)
+                if constexpr(std::is_pointer_v<T>)
                 {
-                    T* arrayObject = static_cast<T*>(arr->At(current++));
-                    *arrayObject   = containerObject;
                     if(addRef)
-                        (*arrayObject)->AddRef();
+                    {
+                        for(size_t o = 0, oLen = container.size(); o < oLen; o++)
+                        {
+                            if(arrayObject[o])
+                                arrayObject[o]->AddRef();
+                        }
+                    }
+                }
+            }
+            else
+            {
+                as::asUINT index = current;
+                for(const T& containerObject : container)
+                {
+                    *static_cast<T*>(arr->At(index++)) = containerObject;
                 }
             }
         }
 
         template<typename T>
-        void AppendListToArray(const std::list<T>& container, as::CScriptArray* arr, bool addRef)
+        static void AppendListToArray(const std::list<T>& container, as::CScriptArray* arr, bool addRef)
         {
             AppendStdContainerToArray<std::list<T>, T>(container, arr, addRef);
         }
 
         template<typename T>
-        void AppendVectorToArray(const std::vector<T>& container, as::CScriptArray* arr, bool addRef)
+        static void AppendVectorToArray(const std::vector<T>& container, as::CScriptArray* arr, bool addRef)
         {
             AppendStdContainerToArray<std::vector<T>, T>(container, arr, addRef);
         }
@@ -0,0 +1,224 @@
+#include "Tilemap.hpp"
+
+#include "Log.hpp"
+
+#include <algorithm>
+#include <cmath> // std::floor
+
+bool EWAN::Tilemap::Create(uint32_t width, uint32_t height, uint32_t tileWidth, uint32_t tileHeight)
+{
+    if(!width || !height || !tileWidth || !tileHeight)
+    {
+        Log::PrintError("Cannot create tilemap " + std::to_string(width) + "x" + std::to_string(height) + " using tiles " + std::to_string(tileWidth) + "x" + std::to_string(tileHeight));
+        return false;
+    }
+
+    Width      = width;
+    Height     = height;
+    TileWidth  = tileWidth;
+    TileHeight = tileHeight;
+
+    Tiles.assign(static_cast<size_t>(Width) * Height, 0);
+
+    ChunksX = (Width + ChunkSize - 1) / ChunkSize;
+    ChunksY = (Height + ChunkSize - 1) / ChunkSize;
+
+    Chunks.clear();
+    Chunks.resize(static_cast<size_t>(ChunksX) * ChunksY);
+
+    QueryResult.clear();
+    Visible = Culled = 0;
+
+    UpdateAtlasColumns();
+
+    return true;
+}
+
+bool EWAN::Tilemap::SetAtlas(const Content& content, const std::string& id)
+{
+    const sf::Texture* atlas = content.Texture.GetAs<sf::Texture>(id);
+    if(!atlas)
+        return false;
+
+    SetAtlas(atlas);
+
+    return true;
+}
+
+bool EWAN::Tilemap::SetAtlas(const Content& content, const Content::Id& id)
+{
+    const sf::Texture* atlas = content.Texture.GetAs<sf::Texture>(id);
+    if(!atlas)
+        return false;
+
+    SetAtlas(atlas);
+
+    return true;
+}
+
+void EWAN::Tilemap::SetAtlas(const sf::Texture* atlas)
+{
+    Atlas = atlas;
+
+    UpdateAtlasColumns();
+}
+
+const sf::Texture* EWAN::Tilemap::GetAtlas() const
+{
+    return Atlas;
+}
+
+uint32_t EWAN::Tilemap::GetWidth() const
+{
+    return Width;
+}
+
+uint32_t EWAN::Tilemap::GetHeight() const
+{
+    return Height;
+}
+
+sf::Vector2u EWAN::Tilemap::GetTileSize() const
+{
+    return {TileWidth, TileHeight};
+}
+
+uint32_t EWAN::Tilemap::GetTile(uint32_t x, uint32_t y) const
+{
+    if(x >= Width || y >= Height)
+        return 0;
+
+    return Tiles[static_cast<size_t>(y) * Width + x];
+}
+
+bool EWAN::Tilemap::SetTile(uint32_t x, uint32_t y, uint32_t tile)
+{
+    if(x >= Width || y >= Height)
+        return false;
+
+    uint32_t& current = Tiles[static_cast<size_t>(y) * Width + x];
+    if(current != tile)
+    {
+        current = tile;
+        Chunks[static_cast<size_t>(y / ChunkSize) * ChunksX + x / ChunkSize].Dirty = true;
+    }
+
+    return true;
+}
+
+bool EWAN::Tilemap::SetTiles(const uint32_t* tiles, size_t count)
+{
+    if(count != Tiles.size())
+    {
+        Log::PrintError("Cannot set " + std::to_string(count) + " tile(s), tilemap size is " + std::to_string(Tiles.size()));
+        return false;
+    }
+
+    std::copy_n(tiles, count, Tiles.begin());
+    InvalidateAll();
+
+    return true;
+}
+
+const std::vector<const EWAN::Tilemap::Chunk*>& EWAN::Tilemap::Query(const sf::FloatRect& area)
+{
+    QueryResult.clear();
+
+    if(Chunks.empty())
+    {
+        Visible = Culled = 0;
+        return QueryResult;
+    }
+
+    const float chunkWidth  = static_cast<float>(ChunkSize * TileWidth);
+    const float chunkHeight = static_cast<float>(ChunkSize * TileHeight);
+
+    // Range of chunks overlapping area, in map coordinates
+    const int64_t left   = static_cast<int64_t>(std::floor((area.left - Position.x) / chunkWidth));
+    const int64_t top    = static_cast<int64_t>(std::floor((area.top - Position.y) / chunkHeight));
+    const int64_t right  = static_cast<int64_t>(std::floor((area.left + area.width - Position.x) / chunkWidth));
+    const int64_t bottom = static_cast<int64_t>(std::floor((area.top + area.height - Position.y) / chunkHeight));
+
+    if(right >= 0 && bottom >= 0 && left < ChunksX && top < ChunksY)
+    {
+        for(int64_t y = std::max<int64_t>(top, 0); y <= std::min<int64_t>(bottom, ChunksY - 1); y++)
+        {
+            for(int64_t x = std::max<int64_t>(left, 0); x <= std::min<int64_t>(right, ChunksX - 1); x++)
+            {
+                const uint32_t chunkX = static_cast<uint32_t>(x);
+                const uint32_t chunkY = static_cast<uint32_t>(y);
+                const Chunk&   chunk  = Chunks[static_cast<size_t>(chunkY) * ChunksX + chunkX];
+
+                if(chunk.Dirty)
+                    BuildChunk(chunkX, chunkY);
+
+                if(chunk.Vertices.getVertexCount())
+                    QueryResult.push_back(&chunk);
+            }
+        }
+    }
+
+    Visible = static_cast<uint32_t>(QueryResult.size());
+    Culled  = static_cast<uint32_t>(Chunks.size()) - Visible;
+
+    return QueryResult;
+}
+
+//
+
+void EWAN::Tilemap::UpdateAtlasColumns()
+{
+    // Texture coordinates depends on atlas layout
+    const uint32_t columns = Atlas && TileWidth ? Atlas->getSize().x / TileWidth : 0;
+    AtlasColumns           = std::max<uint32_t>(columns, 1);
+
+    InvalidateAll();
+}
+
+void EWAN::Tilemap::InvalidateAll()
+{
+    for(Chunk& chunk : Chunks)
+    {
+        chunk.Dirty = true;
+    }
+}
+
+void EWAN::Tilemap::BuildChunk(uint32_t chunkX, uint32_t chunkY)
+{
+    Chunk& chunk = Chunks[static_cast<size_t>(chunkY) * ChunksX + chunkX];
+    chunk.Vertices.clear();
+
+    const uint32_t firstX = chunkX * ChunkSize;
+    const uint32_t firstY = chunkY * ChunkSize;
+    const uint32_t lastX  = std::min(firstX + ChunkSize, Width);
+    const uint32_t lastY  = std::min(firstY + ChunkSize, Height);
+
+    const float tileWidth  = static_cast<float>(TileWidth);
+    const float tileHeight = static_cast<float>(TileHeight);
+
+    for(uint32_t y = firstY; y < lastY; y++)
+    {
+        for(uint32_t x = firstX; x < lastX; x++)
+        {
+            const uint32_t tile = Tiles[static_cast<size_t>(y) * Width + x];
+            if(!tile)
+                continue;
+
+            const float left   = static_cast<float>(x) * tileWidth;
+            const float top    = static_cast<float>(y) * tileHeight;
+            const float right  = left + tileWidth;
+            const float bottom = top + tileHeight;
+
+            const float u = static_cast<float>((tile - 1) % AtlasColumns) * tileWidth;
+            const float v = static_cast<float>((tile - 1) / AtlasColumns) * tileHeight;
+
+            chunk.Vertices.append(sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(u, v)));
+            chunk.Vertices.append(sf::Vertex(sf::Vector2f(right, top), sf::Vector2f(u + tileWidth, v)));
+            chunk.Vertices.append(sf::Vertex(sf::Vector2f(right, bottom), sf::Vector2f(u + tileWidth, v + tileHeight)));
+            chunk.Vertices.append(sf::Vertex(sf::Vector2f(left, bottom), sf::Vector2f(u, v + tileHeight)));
+        }
+    }
+
+    chunk.Dirty = false;
+    Rebuilds++;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Content.hpp"
+
+#include "Libs/SFML.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace EWAN
+{
+    // Grid of tiles using single atlas texture, drawn as chunks of prebuilt quads
+    //
+    // Tile value is index of atlas cell (left to right, top to bottom) increased by one; zero marks empty tile
+    // Chunks are rebuilt only after their tiles has been changed, when they're about to be drawn; chunks outside of view are never touched
+    class Tilemap
+    {
+    public:
+        // Chunk width and height, in tiles
+        static constexpr uint32_t ChunkSize = 16;
+
+        struct Chunk
+        {
+            sf::VertexArray Vertices = sf::VertexArray(sf::Quads);
+
+            bool Dirty = true;
+        };
+
+    public:
+        // Offset of top-left corner of first tile
+        sf::Vector2f Position;
+
+        // Results of last Query(), in chunks
+        uint32_t Visible = 0;
+        uint32_t Culled  = 0;
+
+        // Total amount of chunks rebuilt
+        uint32_t Rebuilds = 0;
+
+    protected:
+        const sf::Texture* Atlas        = nullptr;
+        uint32_t           AtlasColumns = 1;
+
+        uint32_t Width      = 0;
+        uint32_t Height     = 0;
+        uint32_t TileWidth  = 0;
+        uint32_t TileHeight = 0;
+
+        std::vector<uint32_t> Tiles;
+
+        std::vector<Chunk>        Chunks;
+        uint32_t                  ChunksX = 0;
+        uint32_t                  ChunksY = 0;
+        std::vector<const Chunk*> QueryResult;
+
+    public:
+        // Resets all tiles to empty ones
+        bool Create(uint32_t width, uint32_t height, uint32_t tileWidth, uint32_t tileHeight);
+
+        bool SetAtlas(const Content& content, const std::string& id);
+        bool SetAtlas(const Content& content, const Content::Id& id);
+        void SetAtlas(const sf::Texture* atlas);
+
+        const sf::Texture* GetAtlas() const;
+
+        uint32_t     GetWidth() const;
+        uint32_t     GetHeight() const;
+        sf::Vector2u GetTileSize() const;
+
+        // Returns zero for tiles outside of map
+        uint32_t GetTile(uint32_t x, uint32_t y) const;
+        bool     SetTile(uint32_t x, uint32_t y, uint32_t tile);
+
+        // Replaces all tiles, row by row; count must match map size
+        bool SetTiles(const uint32_t* tiles, size_t count);
+
+        // Returns chunks with at least one tile, overlapping given area
+        // Dirty chunks are rebuilt before returning
+        const std::vector<const Chunk*>& Query(const sf::FloatRect& area);
+
+    protected:
+        void UpdateAtlasColumns();
+        void InvalidateAll();
+        void BuildChunk(uint32_t chunkX, uint32_t chunkY);
+    };
+}
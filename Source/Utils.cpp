@@ -3,6 +3,7 @@
 #include "Log.hpp"
 #include "Text.hpp"
 
+#include <algorithm>
 #include <filesystem>
 
 bool EWAN::Utils::ReadFile(const std::string& filename, std::ifstream& fstream)
@@ -45,16 +46,23 @@ bool EWAN::Utils::ReadFile(const std::string& filename, std::string& content)
     if(!ReadFile(filename, fstream))
         return false;
 
-    std::string line;
-    while(!fstream.eof())
-    {
-        std::getline(fstream, line, '\n');
+    // empty file
+    if(!fstream.is_open())
+        return true;
 
-        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
-        line.erase(std::remove(line.begin(), line.end(), '\n'), line.end());
+    // read everything at once, starting after bom (if any)
+    const std::streampos begin = fstream.tellg();
+    fstream.seekg(0, std::ifstream::end);
+    const std::streamoff size = fstream.tellg() - begin;
+    fstream.seekg(begin);
 
-        content += line + "\n";
-    }
+    content.resize(static_cast<size_t>(size));
+    fstream.read(content.data(), size);
+    content.resize(static_cast<size_t>(fstream.gcount()));
+
+    // same result as reading line by line: no carriage returns, and every line (including last one) ends with newline
+    content.erase(std::remove(content.begin(), content.end(), '\r'), content.end());
+    content += '\n';
 
     return true;
 }
@@ -6,7 +6,7 @@
 
 #include "Embed.hpp"
 
-#include <algorithm> // std::clamp
+#include <algorithm>
 
 EWAN::Window::Window() :
     sf::RenderWindow()
@@ -22,19 +22,37 @@ EWAN::Window::~Window()
 bool EWAN::Window::Init(EWAN::Content& content)
 {
     content.Font.NewAs<sf::Font>("*embed/Window/FPS")->loadFromMemory(&Embed::Font::Monospace_Typewriter_ttf, Embed::Font::Monospace_Typewriter_ttf_l);
-    FPS.Text.setFont(*content.Font.GetAs<sf::Font>("*embed/Window/FPS"));
-    FPS.Text.setCharacterSize(14);
+    Hud.SetFont(*content.Font.GetAs<sf::Font>("*embed/Window/FPS"), 14);
+
+    LayersContent = &content;
+
+    // Textures and fonts might be used by frame drawn by render thread
+    for(auto& cache : {&content.Font, &content.RenderTexture, &content.Texture})
+    {
+        cache->CallbackPreDelete = [this](void*) { WaitForRender(); };
+    }
 
     return true;
 }
 
 void EWAN::Window::Finish()
 {
-    if(isOpen())
+    // Layers textures must be released while Content still exists
+    RemoveAllLayers();
+
+    if(LayersContent)
+    {
+        for(auto& cache : {&LayersContent->Font, &LayersContent->RenderTexture, &LayersContent->Texture})
+        {
+            cache->CallbackPreDelete = nullptr;
+        }
+    }
+
+    if(IsOpen())
     {
         Log::PrintInfo("Window finalization...");
 
-        close();
+        Close();
 
         Log::PrintInfo("Window finalization complete");
     }
@@ -44,6 +62,24 @@ void EWAN::Window::Finish()
 
 void EWAN::Window::Open(sf::Uint32 width /*= 0 */, sf::Uint32 height /*= 0 */, sf::Uint32 bitsPerPixel /*= 0 */, const std::string& title /*= {} */, sf::Uint32 style /*= sf::Style::Default */)
 {
+    if(Headless)
+    {
+        // Desktop mode cannot be queried without display
+        if(!width && !height)
+        {
+            width  = 1280;
+            height = 720;
+        }
+
+        Log::Raw(std::to_string(width) + "x" + std::to_string(height) + " (headless)");
+
+        // View is still used for culling and coordinates mapping
+        setView(sf::View(sf::FloatRect(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height))));
+        HeadlessOpen = true;
+
+        return;
+    }
+
     sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
 
     // Use desktop resolution if width and height isn't set
@@ -68,11 +104,48 @@ void EWAN::Window::Open(sf::Uint32 width /*= 0 */, sf::Uint32 height /*= 0 */, s
 
     Log::Raw(std::to_string(width) + "x" + std::to_string(height) + ":" + std::to_string(bitsPerPixel) + " @ " + std::to_string(x) + "," + std::to_string(y));
 
+    // Window is recreated in main thread
+    StopRenderThread();
+
     create(sf::VideoMode(0, 0, bitsPerPixel), title, style);
     setActive(true);
+    setVerticalSyncEnabled(VSync);
 
     setPosition(sf::Vector2i(x, y));
     setSize(sf::Vector2u(width, height));
+
+    // First mouse move should not report delta from (0,0)
+    // Recorded and replayed sessions always start from there, as initial position is not part of record
+    if(Record.GetMode() == InputRecord::Mode::None)
+    {
+        const sf::Vector2i mouse = sf::Mouse::getPosition(*this);
+        Input.MouseX             = mouse.x;
+        Input.MouseY             = mouse.y;
+    }
+
+    ResizeLayers();
+
+    if(Pipelining)
+        StartRenderThread();
+}
+
+void EWAN::Window::Close()
+{
+    if(Headless)
+    {
+        HeadlessOpen = false;
+        return;
+    }
+
+    // Pending frame is drawn before render thread exits
+    StopRenderThread();
+
+    close();
+}
+
+bool EWAN::Window::IsOpen() const
+{
+    return Headless ? HeadlessOpen : isOpen();
 }
 
 //
@@ -81,7 +154,16 @@ bool EWAN::Window::Draw(sf::Sprite* sprite)
 {
     if(sprite)
     {
-        draw(*sprite);
+        if(LayerDrawing)
+        {
+            if(LayerDrawing->Texture)
+                LayerDrawing->Texture->draw(*sprite);
+        }
+        else if(IsBatching())
+            Batch.Add(*sprite);
+        else
+            draw(*sprite);
+
         return true;
     }
 
@@ -93,10 +175,150 @@ bool EWAN::Window::Draw(const Content& content, const std::string& id)
     return Draw(content.Sprite.GetAs<sf::Sprite>(id));
 }
 
+bool EWAN::Window::Draw(const Content& content, const Content::Id& id)
+{
+    return Draw(content.Sprite.GetAs<sf::Sprite>(id));
+}
+
+uint32_t EWAN::Window::DrawScene(Scene& scene)
+{
+    // Bounding box of view in world coordinates, also valid for rotated views
+    const sf::FloatRect area = getView().getInverseTransform().transformRect(sf::FloatRect(-1.0f, -1.0f, 2.0f, 2.0f));
+
+    const std::vector<const Scene::Entry*>& visible = scene.Query(area);
+    for(const Scene::Entry* entry : visible)
+    {
+        if(LayerDrawing)
+        {
+            if(LayerDrawing->Texture)
+                LayerDrawing->Texture->draw(*entry->Sprite);
+        }
+        else if(IsBatching())
+            Batch.Add(*entry->Sprite, entry->Layer);
+        else
+            draw(*entry->Sprite);
+    }
+
+    return static_cast<uint32_t>(visible.size());
+}
+
+uint32_t EWAN::Window::DrawTilemap(Tilemap* tilemap)
+{
+    if(!tilemap)
+        return 0;
+
+    const sf::FloatRect area = getView().getInverseTransform().transformRect(sf::FloatRect(-1.0f, -1.0f, 2.0f, 2.0f));
+
+    sf::RenderStates states;
+    states.texture = tilemap->GetAtlas();
+    states.transform.translate(tilemap->Position);
+
+    const std::vector<const Tilemap::Chunk*>& visible = tilemap->Query(area);
+    for(const Tilemap::Chunk* chunk : visible)
+    {
+        if(LayerDrawing)
+        {
+            if(LayerDrawing->Texture)
+                LayerDrawing->Texture->draw(chunk->Vertices, states);
+        }
+        else if(IsBatching())
+            Batch.Add(chunk->Vertices, states.texture, states.transform, Batch.Layer);
+        else
+            draw(chunk->Vertices, states);
+    }
+
+    return static_cast<uint32_t>(visible.size());
+}
+
+sf::Vector2i EWAN::Window::GetMousePosition() const
+{
+    // Position from last mouse move event is used when live mouse is not available or must not be used,
+    // so recorded and replayed sessions see same values
+    if(Headless || Record.GetMode() != InputRecord::Mode::None)
+        return Input.GetMouse();
+
+    return sf::Mouse::getPosition(*this);
+}
+
+bool EWAN::Window::NextEvent(uint32_t frame, sf::Event& event)
+{
+    if(Record.GetMode() == InputRecord::Mode::Replay)
+    {
+        // Live events are still polled, so OS doesn't consider window unresponsive; only closing window is allowed
+        sf::Event live;
+        while(!Headless && pollEvent(live))
+        {
+            if(live.type == sf::Event::Closed)
+            {
+                event = live;
+                return true;
+            }
+        }
+
+        return Record.Read(frame, event);
+    }
+
+    if(!pollEvent(event))
+        return false;
+
+    Record.Write(frame, event);
+
+    return true;
+}
+
+bool EWAN::Window::IsBatching() const
+{
+    return Batching || Pipelining || Headless;
+}
+
+bool EWAN::Window::GetVSync() const
+{
+    return VSync;
+}
+
+void EWAN::Window::SetVSync(bool enabled)
+{
+    VSync = enabled;
+
+    if(isOpen())
+        setVerticalSyncEnabled(VSync);
+}
+
+bool EWAN::Window::GetPipelining() const
+{
+    return Pipelining;
+}
+
+void EWAN::Window::SetPipelining(bool enabled)
+{
+    Pipelining = enabled;
+
+    if(Pipelining)
+        StartRenderThread();
+    else
+        StopRenderThread();
+}
+
 void EWAN::Window::Update(App* app)
 {
+    Input.Clear();
+
+    // No events without window, unless they're replayed
+    if(Headless && Record.GetMode() != InputRecord::Mode::Replay)
+        return;
+
+    // Coalesced mouse move is delivered before any key or mouse button event which follows it, so callbacks see events in original order
+    bool mouseMovePending = false;
+    auto flushMouseMove   = [app, &mouseMovePending, this]() {
+        if(mouseMovePending)
+        {
+            app->Script.OnMouseMove.Run(Input.MouseX, Input.MouseY);
+            mouseMovePending = false;
+        }
+    };
+
     sf::Event event;
-    while(pollEvent(event))
+    while(NextEvent(app->Timing.Frames, event))
     {
         if(event.type == sf::Event::Closed)
         {
@@ -106,8 +328,13 @@ void EWAN::Window::Update(App* app)
         else if(event.type == sf::Event::KeyPressed)
         {
             app->Keyboard = event.key;
+            flushMouseMove();
             app->Script.OnKeyDown.Run(app->Keyboard.code);
 
+            // Consumed events are not delivered again with batch
+            if(InputBatching && !app->Script.OnKeyDown.Consumed)
+                Input.Events.emplace_back(InputBatch::Type::KeyDown, app->Keyboard.code);
+
             // Hardcoded shortcut, oh noes!
             if(event.key.control && event.key.code == sf::Keyboard::Key::C)
             {
@@ -119,28 +346,121 @@ void EWAN::Window::Update(App* app)
         else if(event.type == sf::Event::KeyReleased)
         {
             app->Keyboard = event.key;
+            flushMouseMove();
             app->Script.OnKeyUp.Run(app->Keyboard.code);
+
+            if(InputBatching && !app->Script.OnKeyUp.Consumed)
+                Input.Events.emplace_back(InputBatch::Type::KeyUp, app->Keyboard.code);
         }
         else if(event.type == sf::Event::MouseButtonPressed)
         {
+            flushMouseMove();
             app->Script.OnMouseDown.Run(event.mouseButton.button);
+
+            if(InputBatching && !app->Script.OnMouseDown.Consumed)
+                Input.Events.emplace_back(InputBatch::Type::MouseDown, event.mouseButton.button);
         }
         else if(event.type == sf::Event::MouseButtonReleased)
         {
+            flushMouseMove();
             app->Script.OnMouseUp.Run(event.mouseButton.button);
+
+            if(InputBatching && !app->Script.OnMouseUp.Consumed)
+                Input.Events.emplace_back(InputBatch::Type::MouseUp, event.mouseButton.button);
         }
         else if(event.type == sf::Event::MouseMoved)
         {
-            app->Script.OnMouseMove.Run(event.mouseMove.x, event.mouseMove.y);
+            if(InputBatching)
+            {
+                Input.AddMouseMove(event.mouseMove.x, event.mouseMove.y);
+                mouseMovePending = true;
+            }
+            else
+            {
+                // Position is tracked even without batching, see GetMousePosition()
+                Input.MouseX = event.mouseMove.x;
+                Input.MouseY = event.mouseMove.y;
+
+                app->Script.OnMouseMove.Run(event.mouseMove.x, event.mouseMove.y);
+            }
         }
         else if(event.type == sf::Event::Resized)
         {
+            // View is used by render thread
+            WaitForRender();
+
             sf::FloatRect visibleArea(0.0f, 0.0f, static_cast<float>(event.size.width), static_cast<float>(event.size.height));
             setView(sf::View(visibleArea));
+
+            ResizeLayers();
         }
     }
+
+    // Key and mouse button events are rare enough to be delivered as they come
+    if(InputBatching)
+    {
+        flushMouseMove();
+
+        if(!Input.IsEmpty())
+            app->Script.OnInputFrame.Run(&Input);
+    }
+}
+
+//
+// Window::InputBatch
+//
+
+void EWAN::Window::InputBatch::Clear()
+{
+    Events.clear();
+
+    MouseDeltaX = MouseDeltaY = 0;
+    MouseMoves                = 0;
+}
+
+bool EWAN::Window::InputBatch::IsEmpty() const
+{
+    return Events.empty() && !MouseMoves;
+}
+
+void EWAN::Window::InputBatch::AddMouseMove(int32_t x, int32_t y)
+{
+    MouseDeltaX += x - MouseX;
+    MouseDeltaY += y - MouseY;
+
+    MouseX = x;
+    MouseY = y;
+
+    MouseMoves++;
 }
 
+uint32_t EWAN::Window::InputBatch::GetCount() const
+{
+    return static_cast<uint32_t>(Events.size());
+}
+
+EWAN::Window::InputBatch::Type EWAN::Window::InputBatch::GetType(uint32_t index) const
+{
+    return index < Events.size() ? Events[index].first : Type::KeyDown;
+}
+
+int32_t EWAN::Window::InputBatch::GetCode(uint32_t index) const
+{
+    return index < Events.size() ? Events[index].second : -1;
+}
+
+sf::Vector2i EWAN::Window::InputBatch::GetMouse() const
+{
+    return {MouseX, MouseY};
+}
+
+sf::Vector2i EWAN::Window::InputBatch::GetMouseDelta() const
+{
+    return {MouseDeltaX, MouseDeltaY};
+}
+
+//
+
 void EWAN::Window::UpdateFPS()
 {
     if(FPS.ClockFPS.getElapsedTime().asSeconds() >= 1.0f)
@@ -158,19 +478,367 @@ void EWAN::Window::UpdateFPS()
 
 void EWAN::Window::Render(Script* script)
 {
-    clear();
-
     FPS.FrameTime = FPS.ClockFrameTime.restart().asSeconds();
 
+    RedrawLayers(script);
+
+    if(Headless)
+    {
+        // Sprites are still collected and sorted, only drawing is skipped
+        script->OnDraw.Run();
+        Batch.Flush(nullptr);
+
+        return;
+    }
+
+    // Render thread might not be running yet
+    if(Pipelining && RenderThread.joinable())
+    {
+        CompositeLayers(true);
+        script->OnDraw.Run();
+
+        // [OnDraw] might close window or disable pipelining, which stops render thread and drops frame recorded so far
+        if(RenderThread.joinable())
+        {
+            CompositeLayers(false);
+            SubmitFrame();
+        }
+        else
+            Batch.Clear();
+
+        return;
+    }
+
+    clear();
+
+    CompositeLayers(true);
     script->OnDraw.Run();
+    CompositeLayers(false);
+
+    // Sprites collected during [OnDraw], and layers when batching; called even when batching is disabled, to keep statistics up to date
+    Batch.Flush(this);
 
     // always last
 
-    if(FPS.Visible && FPS.Min != std::numeric_limits<uint16_t>::max())
+    if(FPS.Visible)
     {
-        FPS.Text.setString(std::to_string(FPS.Min) + " " + std::to_string(FPS.Count) + " " + std::to_string(FPS.Max) + " " + std::to_string(FPS.FrameTime));
-        draw(FPS.Text);
+        Hud.Prepare();
+        Hud.Draw(*this);
     }
 
     display();
 }
+
+//
+// Window layers
+//
+
+bool EWAN::Window::AddLayer(const std::string& name, int32_t order /*= 0 */)
+{
+    if(LayerDrawing)
+    {
+        Log::PrintError("Cannot add layer<" + name + "> during layer redraw");
+        return false;
+    }
+    else if(name.empty() || GetLayer(name))
+    {
+        Log::PrintError("Cannot add layer<" + name + ">");
+        return false;
+    }
+
+    Layer layer;
+    layer.Name  = name;
+    layer.Order = order;
+
+    // No render textures without GPU; layer is still redrawn, but sprites are dropped
+    if(!Headless && LayersContent)
+        layer.Texture = LayersContent->RenderTexture.NewAs<sf::RenderTexture>("*layer/" + name);
+
+    auto it = std::upper_bound(Layers.begin(), Layers.end(), order, [](int32_t value, const Layer& other) { return value < other.Order; });
+    it      = Layers.insert(it, std::move(layer));
+
+    if(it->Texture && isOpen())
+    {
+        const sf::Vector2u size = getSize();
+        it->Texture->create(size.x, size.y);
+        it->Sprite.setTexture(it->Texture->getTexture(), true);
+    }
+
+    return true;
+}
+
+bool EWAN::Window::RemoveLayer(const std::string& name)
+{
+    if(LayerDrawing)
+    {
+        Log::PrintError("Cannot remove layer<" + name + "> during layer redraw");
+        return false;
+    }
+
+    auto it = std::find_if(Layers.begin(), Layers.end(), [&name](const Layer& layer) { return layer.Name == name; });
+    if(it == Layers.end())
+        return false;
+
+    // Texture might be used by render thread
+    WaitForRender();
+
+    if(it->Texture)
+        LayersContent->RenderTexture.Delete("*layer/" + name);
+
+    Layers.erase(it);
+
+    return true;
+}
+
+void EWAN::Window::RemoveAllLayers()
+{
+    WaitForRender();
+
+    for(const Layer& layer : Layers)
+    {
+        if(layer.Texture)
+            LayersContent->RenderTexture.Delete("*layer/" + layer.Name);
+    }
+
+    Layers.clear();
+}
+
+bool EWAN::Window::InvalidateLayer(const std::string& name)
+{
+    Layer* layer = GetLayer(name);
+    if(!layer)
+        return false;
+
+    layer->Dirty = true;
+    layer->Invalidations++;
+
+    return true;
+}
+
+void EWAN::Window::InvalidateAllLayers()
+{
+    for(Layer& layer : Layers)
+    {
+        layer.Dirty = true;
+        layer.Invalidations++;
+    }
+}
+
+bool EWAN::Window::SetLayerVisible(const std::string& name, bool visible)
+{
+    Layer* layer = GetLayer(name);
+    if(!layer)
+        return false;
+
+    layer->Visible = visible;
+
+    return true;
+}
+
+uint32_t EWAN::Window::GetLayerInvalidations(const std::string& name) const
+{
+    const Layer* layer = GetLayer(name);
+
+    return layer ? layer->Invalidations : 0;
+}
+
+uint32_t EWAN::Window::GetLayerRedraws(const std::string& name) const
+{
+    const Layer* layer = GetLayer(name);
+
+    return layer ? layer->Redraws : 0;
+}
+
+EWAN::Window::Layer* EWAN::Window::GetLayer(const std::string& name)
+{
+    for(Layer& layer : Layers)
+    {
+        if(layer.Name == name)
+            return &layer;
+    }
+
+    return nullptr;
+}
+
+const EWAN::Window::Layer* EWAN::Window::GetLayer(const std::string& name) const
+{
+    for(const Layer& layer : Layers)
+    {
+        if(layer.Name == name)
+            return &layer;
+    }
+
+    return nullptr;
+}
+
+void EWAN::Window::ResizeLayers()
+{
+    if(!isOpen())
+        return;
+
+    const sf::Vector2u size = getSize();
+
+    for(Layer& layer : Layers)
+    {
+        if(!layer.Texture || layer.Texture->getSize() == size)
+            continue;
+
+        layer.Texture->create(size.x, size.y);
+        layer.Sprite.setTexture(layer.Texture->getTexture(), true);
+
+        layer.Dirty = true;
+        layer.Invalidations++;
+    }
+}
+
+void EWAN::Window::RedrawLayers(Script* script)
+{
+    for(Layer& layer : Layers)
+    {
+        if(!layer.Dirty || !layer.Visible)
+            continue;
+
+        // Texture might be used by render thread
+        WaitForRender();
+
+        if(layer.Texture)
+        {
+            layer.Texture->setView(getView());
+            layer.Texture->clear(sf::Color::Transparent);
+        }
+
+        LayerDrawing = &layer;
+        script->OnDrawLayer.Run(layer.Name);
+        LayerDrawing = nullptr;
+
+        if(layer.Texture)
+            layer.Texture->display();
+
+        layer.Dirty = false;
+        layer.Redraws++;
+    }
+}
+
+void EWAN::Window::CompositeLayers(bool below)
+{
+    const sf::View& view = getView();
+
+    for(Layer& layer : Layers)
+    {
+        if(!layer.Visible || !layer.Texture)
+            continue;
+        else if((layer.Order < 0) != below)
+            continue;
+
+        // Quad covering whole view
+        const sf::Vector2u size = layer.Texture->getSize();
+        layer.Sprite.setOrigin(static_cast<float>(size.x) / 2.0f, static_cast<float>(size.y) / 2.0f);
+        layer.Sprite.setPosition(view.getCenter());
+        layer.Sprite.setScale(view.getSize().x / static_cast<float>(size.x), view.getSize().y / static_cast<float>(size.y));
+        layer.Sprite.setRotation(view.getRotation());
+
+        // Batch sorting is stable and layers are sorted by order, so lowest and highest Batch layer keeps them below/above all sprites
+        if(IsBatching())
+            Batch.Add(layer.Sprite, below ? INT32_MIN : INT32_MAX);
+        else
+            draw(layer.Sprite);
+    }
+}
+
+//
+// Window pipelining
+//
+
+void EWAN::Window::StartRenderThread()
+{
+    if(RenderThread.joinable() || !isOpen())
+        return;
+
+    // OpenGL context can be active in one thread at a time
+    setActive(false);
+
+    RenderThread = std::thread(&Window::RenderThreadMain, this);
+}
+
+void EWAN::Window::StopRenderThread()
+{
+    if(!RenderThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(RenderLock);
+        RenderStop = true;
+    }
+    RenderSignal.notify_all();
+
+    RenderThread.join();
+    RenderStop = false;
+
+    // Anything recorded after last submitted frame is dropped
+    Batch.Clear();
+
+    setActive(true);
+}
+
+void EWAN::Window::WaitForRender()
+{
+    std::unique_lock<std::mutex> lock(RenderLock);
+    RenderSignal.wait(lock, [this] { return !RenderPending; });
+}
+
+void EWAN::Window::SubmitFrame()
+{
+    {
+        std::unique_lock<std::mutex> lock(RenderLock);
+
+        // Previous frame must be drawn before its buffers can be reused
+        RenderSignal.wait(lock, [this] { return !RenderPending; });
+
+        Batch.Swap(RenderBatch);
+
+        // Statistics of last frame drawn
+        Batch.Sprites   = RenderBatch.Sprites;
+        Batch.DrawCalls = RenderBatch.DrawCalls;
+        Batch.Vertices  = RenderBatch.Vertices;
+
+        // Hud is only drawn by render thread, so it can be safely prepared here
+        RenderHud = FPS.Visible;
+        if(RenderHud)
+            Hud.Prepare();
+
+        RenderPending = true;
+    }
+    RenderSignal.notify_all();
+}
+
+void EWAN::Window::RenderThreadMain()
+{
+    setActive(true);
+
+    std::unique_lock<std::mutex> lock(RenderLock);
+    while(true)
+    {
+        RenderSignal.wait(lock, [this] { return RenderStop || RenderPending; });
+
+        if(!RenderPending)
+            break;
+
+        // Main thread doesn't touch render state until RenderPending is cleared
+        lock.unlock();
+
+        clear();
+        RenderBatch.Flush(this);
+
+        if(RenderHud)
+            Hud.Draw(*this);
+
+        display();
+
+        lock.lock();
+        RenderPending = false;
+        RenderSignal.notify_all();
+    }
+    lock.unlock();
+
+    setActive(false);
+}
@@ -1,12 +1,22 @@
 #pragma once
 
+#include "Batch.hpp"
 #include "Content.hpp"
+#include "Hud.hpp"
+#include "InputRecord.hpp"
+#include "Scene.hpp"
+#include "Tilemap.hpp"
 
 #include "Libs/SFML.hpp"
 
+#include <condition_variable>
 #include <cstdint>
 #include <limits>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace EWAN
 {
@@ -20,7 +30,6 @@ namespace EWAN
         {
             sf::Clock ClockFPS;
             sf::Clock ClockFrameTime;
-            sf::Text  Text;
 
             float FrameTime = 0.0f;
 
@@ -29,10 +38,108 @@ namespace EWAN
             uint16_t Max   = 0;
             uint16_t Frame = 0;
 
+            // Shows Hud
+            bool Visible = true;
+        };
+
+        // Input events collected during single Update(), when batching is enabled
+        // Mouse moves are coalesced into latest position and total delta, other events are kept in order
+        struct InputBatch
+        {
+            enum class Type : int32_t
+            {
+                KeyDown,
+                KeyUp,
+                MouseDown,
+                MouseUp
+            };
+
+            std::vector<std::pair<Type, int32_t>> Events;
+
+            int32_t MouseX      = 0;
+            int32_t MouseY      = 0;
+            int32_t MouseDeltaX = 0;
+            int32_t MouseDeltaY = 0;
+
+            uint32_t MouseMoves = 0;
+
+            void Clear();
+            bool IsEmpty() const;
+
+            void AddMouseMove(int32_t x, int32_t y);
+
+            uint32_t GetCount() const;
+            Type     GetType(uint32_t index) const;
+            int32_t  GetCode(uint32_t index) const;
+
+            sf::Vector2i GetMouse() const;
+            sf::Vector2i GetMouseDelta() const;
+        };
+
+        // Retained layer, drawn into own render texture only when invalidated, and composited with single quad every frame
+        //
+        // Layer is redrawn by [OnDrawLayer], using window view active at that time; sprites drawn during redraw goes into layer texture.
+        // Composited quad always covers whole view, so cached content stays in place when view moves; layers with world content
+        // must be invalidated when view changes. Layers with negative order are composited below sprites drawn in [OnDraw],
+        // other layers above them; same rule applies when batching, regardless of Batch layers used by sprites
+        struct Layer
+        {
+            std::string Name;
+            int32_t     Order = 0;
+
+            // Owned by Content::RenderTexture; null when running headless
+            sf::RenderTexture* Texture = nullptr;
+            sf::Sprite         Sprite;
+
+            uint32_t Invalidations = 0;
+            uint32_t Redraws       = 0;
+
+            bool Dirty   = true;
             bool Visible = true;
         };
 
         EWAN::Window::FPS FPS;
+        EWAN::Hud         Hud;
+
+        // When enabled, mouse moves are coalesced and delivered once before next key/mouse button event or at end of frame,
+        // and [OnInputFrame] receives all events from current frame which haven't been consumed by their own callbacks
+        bool       InputBatching = false;
+        InputBatch Input;
+
+        // When enabled, sprites drawn during [OnDraw] are collected and drawn at end of Render(), sorted by layer/texture/blend mode
+        bool        Batching = false;
+        EWAN::Batch Batch;
+
+        // Set by App before Init(), when running without display and GPU
+        // Open() only creates a view, events are never received, and sprites are collected and sorted but never drawn
+        bool Headless = false;
+
+        // Records events received by Update(), or replaces them with recorded ones
+        InputRecord Record;
+
+    protected:
+        bool HeadlessOpen = false;
+
+        // Reapplied whenever window is opened
+        bool VSync = false;
+
+        // When enabled, [OnDraw] only records sprites into Batch, and recorded frame is drawn by render thread
+        // while main thread is already processing next frame; see SetPipelining()
+        bool Pipelining = false;
+
+        // Render thread state; RenderBatch and RenderHud belongs to render thread while RenderPending is set
+        std::thread             RenderThread;
+        std::mutex              RenderLock;
+        std::condition_variable RenderSignal;
+        EWAN::Batch             RenderBatch;
+        bool                    RenderHud     = false;
+        bool                    RenderPending = false;
+        bool                    RenderStop    = false;
+
+        // Sorted by order; layers with same order keeps order in which they were added
+        std::vector<Layer> Layers;
+        Content*           LayersContent = nullptr;
+        Layer*             LayerDrawing  = nullptr; // set during [OnDrawLayer]
 
         //        uint8_t Unused[4];
 
@@ -45,12 +152,74 @@ namespace EWAN
         void Finish();
 
         void Open(sf::Uint32 width = 0, sf::Uint32 height = 0, sf::Uint32 bitsPerPixel = 32, const std::string& title = {}, sf::Uint32 style = sf::Style::Default);
+        void Close();
+
+        // Same as isOpen(), but aware of headless mode
+        bool IsOpen() const;
 
         bool Draw(sf::Sprite* sprite);
         bool Draw(const Content& content, const std::string& id);
+        bool Draw(const Content& content, const Content::Id& id);
+
+        // Draws scene sprites visible in current view, using their scene layers when batching
+        // Returns amount of sprites drawn
+        uint32_t DrawScene(Scene& scene);
+
+        // Draws tilemap chunks visible in current view, using Batch.Layer when batching
+        // Returns amount of chunks drawn
+        uint32_t DrawTilemap(Tilemap* tilemap);
+
+        sf::Vector2i GetMousePosition() const;
+
+        bool GetVSync() const;
+        void SetVSync(bool enabled);
+
+        // Pipelined rendering moves OpenGL context to render thread, which draws frame N while main thread updates and records frame N+1
+        // Sprites are always batched; deleting textures or fonts from Content waits until render thread finishes current frame
+        bool GetPipelining() const;
+        void SetPipelining(bool enabled);
+
+        // Layers cannot be added or removed during [OnDrawLayer]
+        bool AddLayer(const std::string& name, int32_t order = 0);
+        bool RemoveLayer(const std::string& name);
+        void RemoveAllLayers();
+
+        // Marks layer to be redrawn before next frame
+        bool InvalidateLayer(const std::string& name);
+        void InvalidateAllLayers();
+
+        bool SetLayerVisible(const std::string& name, bool visible);
+
+        uint32_t GetLayerInvalidations(const std::string& name) const;
+        uint32_t GetLayerRedraws(const std::string& name) const;
 
         void Update(App* app);
         void UpdateFPS();
         void Render(Script* script);
+
+    protected:
+        // Returns next event to process during given frame, either polled or replayed
+        bool NextEvent(uint32_t frame, sf::Event& event);
+
+        // Returns true if sprites should be added to Batch instead of drawn immediately
+        bool IsBatching() const;
+
+        Layer*       GetLayer(const std::string& name);
+        const Layer* GetLayer(const std::string& name) const;
+
+        // Recreates layers textures using current window size
+        void ResizeLayers();
+
+        // Runs [OnDrawLayer] for every visible layer marked as dirty
+        void RedrawLayers(Script* script);
+
+        // Draws layers placed below (or above) [OnDraw] sprites; when batching, all layers are added to Batch when `below` is set
+        void CompositeLayers(bool below);
+
+        void StartRenderThread();
+        void StopRenderThread();
+        void WaitForRender();
+        void SubmitFrame();
+        void RenderThreadMain();
     };
 }
@@ -0,0 +1,34 @@
+#include "App.hpp"
+#include "Test.hpp"
+
+TEST_MAIN
+{
+    decltype(App::Options) options;
+
+    TEST_ASSERT(App::ParseOptions({}, options));
+    TEST_ASSERT(!options.Headless);
+    TEST_ASSERT(options.Frames == 0);
+    TEST_ASSERT(options.FrameTime < 0.0f);
+
+    TEST_ASSERT(App::ParseOptions({"--headless", "--frames=600", "--seconds=2.5", "--frame-time=0.01", "--profile-csv=bench.csv", "--profile-json=bench.json"}, options));
+    TEST_ASSERT(options.Headless);
+    TEST_ASSERT(options.Frames == 600);
+    TEST_ASSERT(options.Seconds == 2.5f);
+    TEST_ASSERT(options.FrameTime == 0.01f);
+    TEST_ASSERT(options.ProfileCSV == "bench.csv");
+    TEST_ASSERT(options.ProfileJSON == "bench.json");
+
+    TEST_ASSERT(App::ParseOptions({"--record=input.bin"}, options));
+    TEST_ASSERT(options.Record == "input.bin");
+
+    for(const char* invalid : {"--unknown", "--frames", "--frames=", "--frames=ten", "--frames=10x", "--seconds=-1", "--seconds=inf", "--seconds= 1", "--seconds=1.5s", "--frame-time=-0.5", "--profile-csv=", "--replay="})
+    {
+        decltype(App::Options) rejected;
+        TEST_ASSERT(!App::ParseOptions({invalid}, rejected));
+    }
+
+    decltype(App::Options) both;
+    TEST_ASSERT(!App::ParseOptions({"--record=a.bin", "--replay=b.bin"}, both));
+
+    return EXIT_SUCCESS;
+}
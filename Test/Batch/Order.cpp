@@ -0,0 +1,57 @@
+#include "Batch.hpp"
+#include "Test.hpp"
+
+// Checks that sprites using different state are merged into single draw call only when nothing drawn in between overlaps them
+
+namespace
+{
+    static sf::Sprite MakeSprite(float x, float y)
+    {
+        // Sprites without texture still have bounds set by texture rect
+        sf::Sprite sprite;
+        sprite.setTextureRect(sf::IntRect(0, 0, 10, 10));
+        sprite.setPosition(x, y);
+
+        return sprite;
+    }
+}
+
+TEST_MAIN
+{
+    Batch batch;
+
+    // Overlapping sprite in between must stay on top of first one, and below last one
+    batch.Add(MakeSprite(0.0f, 0.0f), 0, sf::BlendAlpha);
+    batch.Add(MakeSprite(5.0f, 5.0f), 0, sf::BlendAdd);
+    batch.Add(MakeSprite(0.0f, 0.0f), 0, sf::BlendAlpha);
+    batch.Flush(nullptr);
+
+    TEST_ASSERT(batch.Sprites == 3);
+    TEST_ASSERT(batch.DrawCalls == 3);
+
+    // Sprite in between doesn't overlap anything, last sprite joins first draw call
+    batch.Add(MakeSprite(0.0f, 0.0f), 0, sf::BlendAlpha);
+    batch.Add(MakeSprite(100.0f, 100.0f), 0, sf::BlendAdd);
+    batch.Add(MakeSprite(0.0f, 0.0f), 0, sf::BlendAlpha);
+    batch.Flush(nullptr);
+
+    TEST_ASSERT(batch.DrawCalls == 2);
+
+    // Sprites are never moved across layers
+    batch.Add(MakeSprite(0.0f, 0.0f), 2, sf::BlendAlpha);
+    batch.Add(MakeSprite(100.0f, 100.0f), 1, sf::BlendAdd);
+    batch.Add(MakeSprite(0.0f, 0.0f), 0, sf::BlendAlpha);
+    batch.Flush(nullptr);
+
+    TEST_ASSERT(batch.DrawCalls == 3);
+
+    // Layer change alone doesn't require new draw call
+    batch.Add(MakeSprite(0.0f, 0.0f), 1, sf::BlendAlpha);
+    batch.Add(MakeSprite(0.0f, 0.0f), 0, sf::BlendAlpha);
+    batch.Flush(nullptr);
+
+    TEST_ASSERT(batch.DrawCalls == 1);
+    TEST_ASSERT(batch.IsEmpty());
+
+    return EXIT_SUCCESS;
+}
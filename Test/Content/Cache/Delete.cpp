@@ -9,12 +9,22 @@ TEST_MAIN
     {
         Log::Raw(cache->Name);
         cache->New("id");
+
+        size_t preDelete = 0;
+        cache->CallbackPreDelete = [&preDelete](void*) { preDelete++; };
         
         //
         cache->Delete("id");
         //
 
         TEST_ASSERT(cache->Exists("id") == false);
+        TEST_ASSERT(preDelete == 1);
+
+        // Nothing to delete
+        cache->Delete("id");
+        TEST_ASSERT(preDelete == 1);
+
+        cache->CallbackPreDelete = nullptr;
     }
 
     return EXIT_SUCCESS;
@@ -0,0 +1,43 @@
+#include "Content.hpp"
+#include "Test.hpp"
+
+// Hash must be usable at compile time
+static_assert(Content::Id::MakeHash("") == 14695981039346656037ull);
+static_assert(Content::Id::MakeHash("id") != Content::Id::MakeHash("di"));
+
+TEST_MAIN
+{
+    Content c;
+
+    const Content::Id id("id");
+    const Content::Id unknown("unknown");
+
+    TEST_ASSERT(id.Hash == Content::Id::MakeHash("id"));
+    TEST_ASSERT(id.GetName() == "id");
+    TEST_ASSERT(Content::Id().GetName().empty());
+
+    for(auto& cache : CONTENT_CACHE_LIST(c))
+    {
+        Log::Raw(cache->Name);
+
+        // Data added by name can be found by Id, and vice versa
+        void* data = cache->New("id");
+        TEST_ASSERT(data);
+        TEST_ASSERT(cache->Exists(id));
+        TEST_ASSERT(cache->Get(id) == data);
+        TEST_ASSERT(cache->GetInfo(id) == cache->GetInfo("id"));
+        TEST_ASSERT(!cache->Exists(unknown));
+        TEST_ASSERT(!cache->Get(unknown, true));
+
+        TEST_ASSERT(cache->Delete(id));
+        TEST_ASSERT(!cache->Exists("id"));
+        TEST_ASSERT(!cache->Exists(id));
+
+        TEST_ASSERT(cache->New(id));
+        TEST_ASSERT(cache->Exists("id"));
+        TEST_ASSERT(cache->DeleteAll() == 1);
+        TEST_ASSERT(!cache->Exists(id));
+    }
+
+    return EXIT_SUCCESS;
+}
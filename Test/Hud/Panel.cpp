@@ -0,0 +1,49 @@
+#include "Hud.hpp"
+#include "Test.hpp"
+
+// Checks that panels format numbers without std::string, and pass text to sf::Text only when it changes
+
+TEST_MAIN
+{
+    Hud::Panel panel;
+
+    panel.Append("FPS ").Append(60u).Append(" | ").Append(16.6667f, 2).Append(" ms");
+    TEST_ASSERT(panel.GetText() == "FPS 60 | 16.67 ms");
+
+    TEST_ASSERT(panel.Prepare(true));
+    TEST_ASSERT(panel.Changes == 1);
+    TEST_ASSERT(panel.GetLines() == 1);
+
+    // Same text formatted again
+    panel.Clear();
+    panel.Append("FPS ").Append(60u).Append(" | ").Append(16.6667f, 2).Append(" ms");
+    TEST_ASSERT(!panel.Prepare(true));
+    TEST_ASSERT(panel.Changes == 1);
+
+    panel.Clear();
+    panel.Append("FPS ").Append(59u).Append("\nsecond line");
+    TEST_ASSERT(panel.Prepare(true));
+    TEST_ASSERT(panel.Changes == 2);
+    TEST_ASSERT(panel.GetLines() == 2);
+
+    // Hidden panels keeps their text, but doesn't take any space
+    TEST_ASSERT(panel.Prepare(false));
+    TEST_ASSERT(panel.GetLines() == 0);
+    TEST_ASSERT(!panel.Prepare(false));
+    TEST_ASSERT(panel.Prepare(true));
+    TEST_ASSERT(panel.Changes == 2);
+
+    panel.Clear();
+    TEST_ASSERT(panel.GetText().empty());
+    TEST_ASSERT(panel.Prepare(true));
+    TEST_ASSERT(panel.GetLines() == 0);
+
+    // Anything which doesn't fit is dropped
+    for(size_t count = 0; count < Hud::Panel::Capacity; count++)
+    {
+        panel.Append("x").Append(1234567890u);
+    }
+    TEST_ASSERT(panel.GetText().size() < Hud::Panel::Capacity);
+
+    return EXIT_SUCCESS;
+}
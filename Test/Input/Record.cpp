@@ -0,0 +1,67 @@
+#include "InputRecord.hpp"
+#include "Test.hpp"
+
+#include <filesystem>
+
+// Checks that replayed events arrive in same frames, with same data, as recorded ones
+
+TEST_MAIN
+{
+    const std::string filename = (std::filesystem::temp_directory_path() / "EWAN.Test.InputRecord.bin").string();
+
+    sf::Event key;
+    key.type        = sf::Event::KeyPressed;
+    key.key.code    = sf::Keyboard::Space;
+    key.key.shift   = true;
+    key.key.control = false;
+    key.key.alt     = false;
+    key.key.system  = false;
+
+    sf::Event mouse;
+    mouse.type        = sf::Event::MouseMoved;
+    mouse.mouseMove.x = 320;
+    mouse.mouseMove.y = -16;
+
+    sf::Event joystick;
+    joystick.type                       = sf::Event::JoystickConnected;
+    joystick.joystickConnect.joystickId = 0;
+
+    InputRecord record;
+    TEST_ASSERT(record.StartRecord(filename, 0.01f));
+    TEST_ASSERT(record.GetMode() == InputRecord::Mode::Record);
+
+    record.Write(0, key);
+    record.Write(0, mouse);
+    record.Write(3, joystick);
+    record.Write(5, mouse);
+    record.Finish(10);
+    TEST_ASSERT(record.GetMode() == InputRecord::Mode::None);
+
+    InputRecord replay;
+    TEST_ASSERT(replay.StartReplay(filename));
+    TEST_ASSERT(replay.GetFrameTime() == 0.01f);
+
+    sf::Event event;
+    TEST_ASSERT(replay.Read(0, event) && event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Space && event.key.shift);
+    TEST_ASSERT(replay.Read(0, event) && event.type == sf::Event::MouseMoved && event.mouseMove.x == 320 && event.mouseMove.y == -16);
+    TEST_ASSERT(!replay.Read(0, event));
+
+    // Unsupported events are not recorded
+    for(uint32_t frame = 1; frame < 5; frame++)
+    {
+        TEST_ASSERT(!replay.Read(frame, event));
+        TEST_ASSERT(!replay.IsFinished(frame));
+    }
+
+    TEST_ASSERT(replay.Read(5, event) && event.type == sf::Event::MouseMoved);
+    TEST_ASSERT(!replay.Read(5, event));
+    TEST_ASSERT(!replay.IsFinished(9));
+    TEST_ASSERT(replay.IsFinished(10));
+    replay.Finish(10);
+
+    std::filesystem::remove(filename);
+
+    TEST_ASSERT(!replay.StartReplay(filename));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,55 @@
+#include "Math.hpp"
+#include "Test.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Compares Math bulk helpers with SFML functions applied point by point
+
+namespace
+{
+    static bool Same(const sf::Vector2f& left, const sf::Vector2f& right)
+    {
+        return std::abs(left.x - right.x) < 0.001f && std::abs(left.y - right.y) < 0.001f;
+    }
+}
+
+TEST_MAIN
+{
+    sf::Transform transform;
+    transform.translate(10.0f, -20.0f).rotate(30.0f).scale(2.0f, 0.5f);
+
+    // Odd count, to cover scalar tail
+    std::vector<sf::Vector2f> points;
+    for(int32_t p = 0; p < 1001; p++)
+    {
+        points.emplace_back(static_cast<float>(p % 37) - 18.0f, static_cast<float>(p % 53) * 0.25f);
+    }
+
+    std::vector<sf::Vector2f> transformed = points;
+    Math::TransformPoints(transform, transformed.data(), transformed.size());
+
+    for(size_t p = 0; p < points.size(); p++)
+    {
+        TEST_ASSERT(Same(transformed[p], transform.transformPoint(points[p])));
+    }
+
+    for(const size_t count : {1, 2, 3, 4, 1001})
+    {
+        sf::Vector2f min = points[0];
+        sf::Vector2f max = points[0];
+        for(size_t p = 1; p < count; p++)
+        {
+            min.x = std::min(min.x, points[p].x);
+            min.y = std::min(min.y, points[p].y);
+            max.x = std::max(max.x, points[p].x);
+            max.y = std::max(max.y, points[p].y);
+        }
+
+        TEST_ASSERT(Math::GetBounds(points.data(), count) == sf::FloatRect(min, max - min));
+    }
+
+    TEST_ASSERT(Math::GetBounds(points.data(), 0) == sf::FloatRect());
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+#include "Profiler.hpp"
+#include "Test.hpp"
+
+// Checks that incomplete interval is reported by Finish()
+
+TEST_MAIN
+{
+    Profiler profiler;
+    profiler.Interval = 3600.0f;
+
+    profiler.Start();
+    for(uint32_t frame = 0; frame < 10; frame++)
+    {
+        profiler.Record(Profiler::Phase::Update, std::chrono::steady_clock::now());
+        TEST_ASSERT(!profiler.NextFrame());
+    }
+
+    TEST_ASSERT(profiler.GetReports().empty());
+
+    profiler.Finish();
+
+    TEST_ASSERT(profiler.GetReports().size() == 1);
+    TEST_ASSERT(profiler.GetLast(Profiler::Phase::Frame).Count == 10);
+    TEST_ASSERT(profiler.GetTotal(Profiler::Phase::Update).Count == 10);
+
+    // Nothing recorded since last report
+    profiler.Finish();
+    TEST_ASSERT(profiler.GetReports().size() == 1);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,71 @@
+#include "Profiler.hpp"
+#include "Test.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Compares histogram percentiles with exact percentiles of same values
+
+namespace
+{
+    // Reported value is upper bound of bucket, so it's never lower than exact value, and never higher than bucket precision allows
+    static bool Close(uint32_t reported, uint32_t exact)
+    {
+        return reported >= exact && reported - exact <= std::max<uint32_t>(exact / Histogram::SubBucketCount, 1);
+    }
+
+    static uint32_t Exact(std::vector<uint32_t> values, double percentile)
+    {
+        std::sort(values.begin(), values.end());
+
+        const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(values.size())));
+
+        return values[std::max<size_t>(rank, 1) - 1];
+    }
+}
+
+TEST_MAIN
+{
+    for(uint32_t value : {0u, 1u, 31u, 32u, 33u, 1000u, 16'667u, 1'000'000u, UINT32_MAX})
+    {
+        const uint32_t index = Histogram::GetIndex(value);
+
+        TEST_ASSERT(index < Histogram::BucketCount);
+        TEST_ASSERT(Close(Histogram::GetValue(index), value) || Histogram::GetValue(index) == UINT32_MAX);
+    }
+
+    // Mostly steady 60fps with occasional stutter
+    std::vector<uint32_t> values;
+    for(uint32_t v = 0; v < 10'000; v++)
+    {
+        values.push_back(v % 100 == 0 ? 50'000 + v : 16'000 + (v * 7919) % 1'500);
+    }
+
+    Histogram histogram;
+    for(uint32_t value : values)
+    {
+        histogram.Record(value);
+    }
+
+    TEST_ASSERT(histogram.GetCount() == values.size());
+    TEST_ASSERT(histogram.GetMax() == *std::max_element(values.begin(), values.end()));
+    TEST_ASSERT(histogram.GetPercentile(100.0) == histogram.GetMax());
+
+    for(double percentile : {0.0, 50.0, 95.0, 99.0, 99.5, 99.9})
+    {
+        TEST_ASSERT(Close(histogram.GetPercentile(percentile), Exact(values, percentile)));
+    }
+
+    Histogram merged;
+    merged.Add(histogram);
+    merged.Add(histogram);
+
+    TEST_ASSERT(merged.GetCount() == histogram.GetCount() * 2);
+    TEST_ASSERT(merged.GetPercentile(99.0) == histogram.GetPercentile(99.0));
+
+    histogram.Reset();
+    TEST_ASSERT(histogram.GetCount() == 0);
+    TEST_ASSERT(histogram.GetPercentile(50.0) == 0);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,88 @@
+#include "Scene.hpp"
+#include "Test.hpp"
+
+// Checks that scene queries return same sprites as brute force bounds test, in draw order
+
+namespace
+{
+    static size_t BruteForce(const std::vector<sf::Sprite>& sprites, const sf::FloatRect& area)
+    {
+        size_t result = 0;
+        for(const sf::Sprite& sprite : sprites)
+        {
+            if(sprite.getGlobalBounds().intersects(area))
+                result++;
+        }
+
+        return result;
+    }
+}
+
+TEST_MAIN
+{
+    // Sprites without texture still have bounds set by texture rect
+    std::vector<sf::Sprite> sprites(1000);
+    std::vector<uint32_t>   ids;
+
+    Scene scene;
+    for(size_t s = 0; s < sprites.size(); s++)
+    {
+        sprites[s].setTextureRect(sf::IntRect(0, 0, 40, 40));
+        sprites[s].setPosition(static_cast<float>((s * 37) % 5000) - 2500.0f, static_cast<float>((s * 91) % 3000) - 1500.0f);
+
+        const uint32_t id = scene.Insert(&sprites[s], static_cast<int32_t>(s % 3));
+        TEST_ASSERT(id);
+
+        ids.push_back(id);
+    }
+
+    TEST_ASSERT(scene.Insert(nullptr) == 0);
+    TEST_ASSERT(scene.GetSize() == sprites.size());
+
+    const sf::FloatRect view(-400.0f, -300.0f, 800.0f, 600.0f);
+    const sf::FloatRect everything(-10000.0f, -10000.0f, 20000.0f, 20000.0f);
+
+    const std::vector<const Scene::Entry*>& visible = scene.Query(view);
+    TEST_ASSERT(visible.size() == BruteForce(sprites, view));
+    TEST_ASSERT(scene.Visible + scene.Culled == sprites.size());
+
+    for(size_t v = 1; v < visible.size(); v++)
+    {
+        TEST_ASSERT(visible[v - 1]->Layer < visible[v]->Layer || (visible[v - 1]->Layer == visible[v]->Layer && visible[v - 1]->Order < visible[v]->Order));
+    }
+
+    TEST_ASSERT(scene.Query(everything).size() == sprites.size());
+
+    // Move everything into view
+    std::vector<sf::Vector2f> positions(ids.size(), sf::Vector2f(0.0f, 0.0f));
+    TEST_ASSERT(scene.SetPositions(ids.data(), positions.data(), ids.size()) == ids.size());
+    TEST_ASSERT(scene.Query(view).size() == sprites.size());
+    TEST_ASSERT(scene.Culled == 0);
+
+    // Moved outside of scene
+    sprites[0].setPosition(5000.0f, 5000.0f);
+    TEST_ASSERT(scene.Query(view).size() == sprites.size());
+    TEST_ASSERT(scene.Update(ids[0]));
+    TEST_ASSERT(scene.Query(view).size() == sprites.size() - 1);
+
+    scene.SetCellSize(64.0f);
+    TEST_ASSERT(scene.Query(view).size() == sprites.size() - 1);
+
+    TEST_ASSERT(scene.Remove(ids[1]));
+    TEST_ASSERT(!scene.Remove(ids[1]));
+    TEST_ASSERT(!scene.Update(ids[1]));
+    TEST_ASSERT(scene.GetSize() == sprites.size() - 1);
+    TEST_ASSERT(scene.Query(view).size() == sprites.size() - 2);
+
+    // Same sprite inserted twice
+    TEST_ASSERT(scene.Insert(&sprites[2]));
+    TEST_ASSERT(scene.RemoveSprite(&sprites[2]) == 2);
+    TEST_ASSERT(scene.RemoveSprite(&sprites[2]) == 0);
+    TEST_ASSERT(scene.Query(view).size() == sprites.size() - 3);
+
+    scene.Clear();
+    TEST_ASSERT(scene.GetSize() == 0);
+    TEST_ASSERT(scene.Query(everything).empty());
+
+    return EXIT_SUCCESS;
+}
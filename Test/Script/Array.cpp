@@ -0,0 +1,83 @@
+#include "Benchmark.hpp"
+#include "Test.hpp"
+
+#include <numeric>
+
+// Compares Script::AppendVectorToArray() with copying elements one by one; test fails if array content is different than source
+
+namespace
+{
+    template<typename T>
+    static void AppendOneByOne(const std::vector<T>& container, as::CScriptArray* arr)
+    {
+        as::asUINT current = arr->GetSize();
+        arr->Resize(static_cast<as::asUINT>(current + container.size()));
+
+        for(const T& containerObject : container)
+        {
+            *static_cast<T*>(arr->At(current++)) = containerObject;
+        }
+    }
+
+    template<typename T>
+    static bool Run(as::asIScriptEngine* engine, const std::string& decl, const std::vector<T>& container)
+    {
+        as::asITypeInfo* type = engine->GetTypeInfoByDecl(decl.c_str());
+        if(!type)
+            return false;
+
+        as::CScriptArray* slow = as::CScriptArray::Create(type);
+        as::CScriptArray* fast = as::CScriptArray::Create(type);
+
+        const int64_t slowTime = Benchmark::Measure(1, [&container, slow]() {
+            AppendOneByOne(container, slow);
+            return true;
+        });
+        const int64_t fastTime = Benchmark::Measure(1, [&container, fast]() {
+            Script::AppendVectorToArray(container, fast, false);
+            return true;
+        });
+
+        Log::Raw(decl + " x" + std::to_string(container.size()) + " : one by one = " + std::to_string(slowTime) + "us, bulk = " + std::to_string(fastTime) + "us");
+
+        bool result = fast->GetSize() == container.size();
+        for(as::asUINT i = 0; result && i < fast->GetSize(); i++)
+        {
+            result = *static_cast<const T*>(fast->At(i)) == container[i];
+        }
+
+        slow->Release();
+        fast->Release();
+
+        return result;
+    }
+}
+
+TEST_MAIN
+{
+    as::asIScriptEngine* engine = Benchmark::CreateEngine();
+    TEST_ASSERT(engine);
+
+    bool result = true;
+    for(const size_t size : {10'000, 1'000'000})
+    {
+        std::vector<int32_t> numbers(size);
+        std::iota(numbers.begin(), numbers.end(), 0);
+
+        result = result && Run(engine, "array<int>", numbers);
+    }
+
+    std::vector<std::string> strings(10'000);
+    for(size_t s = 0; s < strings.size(); s++)
+    {
+        strings[s] = "content/" + std::to_string(s);
+    }
+
+    result = result && Run(engine, "array<string>", strings);
+
+    engine->ShutDownAndRelease();
+
+    TEST_ASSERT(result);
+
+    return EXIT_SUCCESS;
+}
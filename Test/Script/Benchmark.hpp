@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Script.hpp"
+
+#include <chrono>
+
+// Helpers shared by script benchmarks
+// Results are informational only, benchmarks fails only if scripts cannot run or produce wrong results
+
+namespace Benchmark
+{
+    // Returns time spent calling `call` given amount of times, in microseconds, or -1 as soon as any call returns false
+    template<typename F>
+    inline int64_t Measure(uint32_t count, F&& call)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for(uint32_t c = 0; c < count; c++)
+        {
+            if(!call())
+                return -1;
+        }
+
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Prepares context and executes function; `init` is called after Prepare(), and can be used to set arguments
+    template<typename F>
+    inline bool Execute(as::asIScriptContext* context, as::asIScriptFunction* function, F&& init)
+    {
+        if(!function || context->Prepare(function) < 0)
+            return false;
+
+        init(context);
+
+        return context->Execute() == as::asEXECUTION_FINISHED;
+    }
+
+    // Returns private engine with array and string addons, without any EWAN API
+    inline as::asIScriptEngine* CreateEngine()
+    {
+        as::asIScriptEngine* engine = as::asCreateScriptEngine();
+        if(!engine)
+            return nullptr;
+
+        as::RegisterScriptArray(engine, true);
+        as::RegisterStdString(engine);
+
+        return engine;
+    }
+
+    // Returns nullptr if source cannot be built
+    inline as::asIScriptModule* BuildModule(as::asIScriptEngine* engine, const char* source)
+    {
+        as::asIScriptModule* module = engine->GetModule("Benchmark", as::asGM_ALWAYS_CREATE);
+        if(module->AddScriptSection("Benchmark", source) < 0 || module->Build() < 0)
+            return nullptr;
+
+        return module;
+    }
+}
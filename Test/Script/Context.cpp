@@ -0,0 +1,112 @@
+#include "Benchmark.hpp"
+#include "Test.hpp"
+
+// Compares tight script loop executed in plain context and in context with line callback installed,
+// and repeated short calls with context unprepared after every call and with context kept prepared for same function
+
+namespace
+{
+    static const char* Source = R"(
+        int Loop(int count)
+        {
+            int result = 0;
+            for(int i = 0; i < count; i++)
+            {
+                result += i % 7;
+            }
+
+            return result;
+        }
+
+        int Short(int value)
+        {
+            return value + 1;
+        }
+    )";
+
+    static constexpr int32_t  LoopCount  = 1'000'000;
+    static constexpr uint32_t ShortCalls = 100'000;
+
+    static uint32_t LineCalls = 0;
+
+    // Same lookup as Script::CallbackContextLine(), benchmark functions have no user data
+    static void LineCallback(as::asIScriptContext* context, void*)
+    {
+        if(!context->GetFunction()->GetUserData(Script::UserData::IDX))
+            LineCalls++;
+    }
+
+    static int64_t RunLoop(as::asIScriptContext* context, as::asIScriptFunction* function, int32_t& result)
+    {
+        return Benchmark::Measure(1, [&]() -> bool {
+            if(!Benchmark::Execute(context, function, [](as::asIScriptContext* ctx) { ctx->SetArgDWord(0, LoopCount); }))
+                return false;
+
+            result = static_cast<int32_t>(context->GetReturnDWord());
+            return true;
+        });
+    }
+
+    // Mimics Event::Run() + Script::CallbackContextReturn()
+    static int64_t RunShort(as::asIScriptContext* context, as::asIScriptFunction* function, bool unprepare, int32_t& result)
+    {
+        result = 0;
+
+        return Benchmark::Measure(ShortCalls, [&]() -> bool {
+            if(!Benchmark::Execute(context, function, [result](as::asIScriptContext* ctx) { ctx->SetArgDWord(0, static_cast<as::asDWORD>(result)); }))
+                return false;
+
+            result = static_cast<int32_t>(context->GetReturnDWord());
+
+            if(unprepare)
+                context->Unprepare();
+
+            return true;
+        });
+    }
+}
+
+TEST_MAIN
+{
+    as::asIScriptEngine* engine = Benchmark::CreateEngine();
+    TEST_ASSERT(engine);
+
+    as::asIScriptModule* module = Benchmark::BuildModule(engine, Source);
+    TEST_ASSERT(module);
+
+    as::asIScriptFunction* function = module->GetFunctionByDecl("int Loop(int)");
+    TEST_ASSERT(function);
+
+    as::asIScriptContext* plain = engine->CreateContext();
+    as::asIScriptContext* debug = engine->CreateContext();
+    TEST_ASSERT(debug->SetLineCallback(as::asFUNCTION(LineCallback), nullptr, as::asCALL_CDECL) >= 0);
+
+    as::asIScriptFunction* shortFunction = module->GetFunctionByDecl("int Short(int)");
+    TEST_ASSERT(shortFunction);
+
+    int32_t plainResult = 0, debugResult = 0, unpreparedResult = 0, preparedResult = 0;
+
+    const int64_t plainTime      = RunLoop(plain, function, plainResult);
+    const int64_t debugTime      = RunLoop(debug, function, debugResult);
+    const int64_t unpreparedTime = RunShort(plain, shortFunction, true, unpreparedResult);
+    const int64_t preparedTime   = RunShort(plain, shortFunction, false, preparedResult);
+
+    plain->Release();
+    debug->Release();
+    engine->ShutDownAndRelease();
+
+    TEST_ASSERT(plainTime >= 0);
+    TEST_ASSERT(debugTime >= 0);
+    TEST_ASSERT(unpreparedTime >= 0);
+    TEST_ASSERT(preparedTime >= 0);
+
+    Log::Raw("Loop x" + std::to_string(LoopCount) + " : plain = " + std::to_string(plainTime) + "us, debug = " + std::to_string(debugTime) + "us, lines = " + std::to_string(LineCalls));
+    Log::Raw("Short x" + std::to_string(ShortCalls) + " : unprepared = " + std::to_string(unpreparedTime) + "us, prepared = " + std::to_string(preparedTime) + "us");
+
+    TEST_ASSERT(plainResult == debugResult);
+    TEST_ASSERT(unpreparedResult == static_cast<int32_t>(ShortCalls));
+    TEST_ASSERT(preparedResult == static_cast<int32_t>(ShortCalls));
+    TEST_ASSERT(LineCalls > 0);
+
+    return EXIT_SUCCESS;
+}
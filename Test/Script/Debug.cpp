@@ -0,0 +1,119 @@
+#include "Benchmark.hpp"
+#include "Test.hpp"
+
+#include <algorithm>
+
+// Checks that functions marked for debugging runs in contexts with line callback, other functions in plain contexts,
+// switching between both when Script.DebugContexts changes, and that every context returns to pool it came from
+
+namespace
+{
+    static const char* Source = R"(
+        int Plain(int value)
+        {
+            return value + 1;
+        }
+
+        int Traced(int value)
+        {
+            return value + 2;
+        }
+    )";
+
+    // Engine setup is not available outside of Script
+    class DebugScript : public Script
+    {
+    public:
+        using Script::CreateEngine;
+        using Script::DestroyEngine;
+    };
+
+    // Mimics Event::Run()
+    static as::asIScriptContext* Run(Script& script, as::asIScriptFunction* function, int32_t value, int32_t& result)
+    {
+        as::asIScriptContext* context = script.RequestContext(function->GetEngine(), script.IsDebugFunction(function), function);
+        if(!context)
+            return nullptr;
+
+        const bool executed = Benchmark::Execute(context, function, [value](as::asIScriptContext* ctx) { ctx->SetArgDWord(0, static_cast<as::asDWORD>(value)); });
+        Script::UserData::Get(context)->Function = function;
+
+        result = executed ? static_cast<int32_t>(context->GetReturnDWord()) : -1;
+        function->GetEngine()->ReturnContext(context);
+
+        return executed ? context : nullptr;
+    }
+
+    static bool InPool(const std::vector<as::asIScriptContext*>& pool, as::asIScriptContext* context)
+    {
+        return std::find(pool.begin(), pool.end(), context) != pool.end();
+    }
+}
+
+TEST_MAIN
+{
+    DebugScript script;
+
+    as::asIScriptEngine* engine = script.CreateEngine();
+    TEST_ASSERT(engine);
+
+    as::asIScriptModule* module = Benchmark::BuildModule(engine, Source);
+    TEST_ASSERT(module);
+
+    as::asIScriptFunction* plain  = module->GetFunctionByDecl("int Plain(int)");
+    as::asIScriptFunction* traced = module->GetFunctionByDecl("int Traced(int)");
+    TEST_ASSERT(plain && traced);
+
+    // Same as LoadModule() + [Debug ON] metadata
+    plain->SetUserData(new Script::UserData::Function, Script::UserData::IDX);
+    traced->SetUserData(new Script::UserData::Function, Script::UserData::IDX);
+    Script::UserData::Get(traced)->Debug = true;
+
+    Script::UserData::Engine* engineData = Script::UserData::Get(engine);
+    int32_t                   result     = 0;
+
+    TEST_ASSERT(script.DebugContexts);
+    TEST_ASSERT(script.IsDebugFunction(traced));
+    TEST_ASSERT(!script.IsDebugFunction(plain));
+
+    // Debug function gets context with line callback, and it's returned to debug pool
+    as::asIScriptContext* debugContext = Run(script, traced, 1, result);
+    TEST_ASSERT(debugContext && result == 3);
+    TEST_ASSERT(Script::UserData::Get(debugContext)->Debug);
+    TEST_ASSERT(InPool(engineData->ContextCacheDebug, debugContext));
+    TEST_ASSERT(!InPool(engineData->ContextCache, debugContext));
+
+    // Plain function never gets debug context, even if there's one available
+    as::asIScriptContext* plainContext = Run(script, plain, 1, result);
+    TEST_ASSERT(plainContext && plainContext != debugContext && result == 2);
+    TEST_ASSERT(!Script::UserData::Get(plainContext)->Debug);
+    TEST_ASSERT(InPool(engineData->ContextCache, plainContext));
+    TEST_ASSERT(!InPool(engineData->ContextCacheDebug, plainContext));
+
+    // Debug contexts disabled, debug function runs in plain context, debug pool is left untouched
+    script.DebugContexts = false;
+    TEST_ASSERT(!script.IsDebugFunction(traced));
+
+    as::asIScriptContext* context = Run(script, traced, 2, result);
+    TEST_ASSERT(context == plainContext && result == 4);
+    TEST_ASSERT(!Script::UserData::Get(context)->Debug);
+    TEST_ASSERT(InPool(engineData->ContextCache, context));
+    TEST_ASSERT(engineData->ContextCacheDebug.size() == 1 && engineData->ContextCacheDebug.back() == debugContext);
+
+    // Debug contexts enabled again, debug function gets back its own context, still prepared for it
+    script.DebugContexts = true;
+    TEST_ASSERT(script.IsDebugFunction(traced));
+
+    context = script.RequestContext(engine, script.IsDebugFunction(traced), traced);
+    TEST_ASSERT(context == debugContext);
+    TEST_ASSERT(context->GetFunction() == traced);
+    engine->ReturnContext(context);
+
+    context = Run(script, traced, 3, result);
+    TEST_ASSERT(context == debugContext && result == 5);
+    TEST_ASSERT(InPool(engineData->ContextCacheDebug, context));
+
+    script.DestroyEngine(engine);
+
+    return EXIT_SUCCESS;
+}
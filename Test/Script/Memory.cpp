@@ -0,0 +1,88 @@
+#include "Benchmark.hpp"
+#include "Test.hpp"
+
+// Compares default allocator with Script::Memory pools; test fails if pools are not used
+
+namespace
+{
+    static const char* Source = R"(
+        int Counter = 0;
+
+        void Event(int value)
+        {
+            Counter += value;
+        }
+
+        void Arrays()
+        {
+            for(int i = 0; i < 100; i++)
+            {
+                array<int> numbers(16);
+                numbers.insertLast(i);
+
+                array<string> strings = {"a", "b", "c"};
+                strings.insertLast("d");
+            }
+        }
+    )";
+
+    static constexpr uint32_t EventCalls  = 100000;
+    static constexpr uint32_t ArraysCalls = 1000;
+
+    static bool Run(const std::string& name)
+    {
+        as::asIScriptEngine* engine = Benchmark::CreateEngine();
+        if(!engine)
+            return false;
+
+        as::asIScriptModule* module = Benchmark::BuildModule(engine, Source);
+        if(!module)
+        {
+            engine->ShutDownAndRelease();
+            return false;
+        }
+
+        as::asIScriptContext*  context = engine->CreateContext();
+        as::asIScriptFunction* event   = module->GetFunctionByDecl("void Event(int)");
+        as::asIScriptFunction* arrays  = module->GetFunctionByDecl("void Arrays()");
+
+        const int64_t eventTime = Benchmark::Measure(EventCalls, [context, event]() {
+            return Benchmark::Execute(context, event, [](as::asIScriptContext* ctx) { ctx->SetArgDWord(0, 1); });
+        });
+        const int64_t arraysTime = Benchmark::Measure(ArraysCalls, [context, arrays]() {
+            return Benchmark::Execute(context, arrays, [](as::asIScriptContext*) {});
+        });
+
+        context->Release();
+        engine->ShutDownAndRelease();
+
+        if(eventTime < 0 || arraysTime < 0)
+            return false;
+
+        Log::Raw(name + " : Event x" + std::to_string(EventCalls) + " = " + std::to_string(eventTime) + "us");
+        Log::Raw(name + " : Arrays x" + std::to_string(ArraysCalls) + " = " + std::to_string(arraysTime) + "us");
+
+        return true;
+    }
+}
+
+TEST_MAIN
+{
+    // Memory functions can be changed only when no engine exists
+    TEST_ASSERT(Run("default"));
+
+    TEST_ASSERT(Script::Memory::Init());
+    Script::Memory::NewFrame();
+
+    TEST_ASSERT(Run("pooled"));
+
+    const Script::Memory::Stats stats = Script::Memory::NewFrame();
+    Log::Raw("pooled : allocations = " + std::to_string(stats.FrameAllocations) + " frees = " + std::to_string(stats.FrameFrees) + " pool = " + std::to_string(stats.PoolBytes) + " bytes");
+
+    TEST_ASSERT(stats.FrameAllocations > 0);
+    TEST_ASSERT(stats.FrameFrees > 0);
+    TEST_ASSERT(stats.PoolBytes > 0);
+    TEST_ASSERT(Script::Memory::NewFrame().FrameAllocations == 0);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+#include "Benchmark.hpp"
+#include "Test.hpp"
+
+// Checks that context returned after running event callback stays prepared for it, and is unprepared when its module is unloaded
+
+namespace
+{
+    static const char* Source = R"(
+        int First(int value)
+        {
+            return value + 1;
+        }
+
+        int Second(int value)
+        {
+            return value + 2;
+        }
+    )";
+
+    // Engine setup is not available outside of Script
+    class PoolScript : public Script
+    {
+    public:
+        using Script::CreateEngine;
+        using Script::DestroyEngine;
+    };
+
+    // Mimics Event::Run()
+    static as::asIScriptContext* Run(Script& script, as::asIScriptFunction* function, int32_t value, int32_t& result)
+    {
+        as::asIScriptContext* context = script.RequestContext(function->GetEngine(), false, function);
+        if(!context)
+            return nullptr;
+
+        const bool executed = Benchmark::Execute(context, function, [value](as::asIScriptContext* ctx) { ctx->SetArgDWord(0, static_cast<as::asDWORD>(value)); });
+        Script::UserData::Get(context)->Function = function;
+
+        result = executed ? static_cast<int32_t>(context->GetReturnDWord()) : -1;
+        function->GetEngine()->ReturnContext(context);
+
+        return executed ? context : nullptr;
+    }
+
+    // Contexts are kept prepared only if they've been used by event callback
+    static void ReturnPrepared(as::asIScriptContext* context)
+    {
+        Script::UserData::Get(context)->Function = context->GetFunction();
+        context->GetEngine()->ReturnContext(context);
+    }
+}
+
+TEST_MAIN
+{
+    PoolScript script;
+
+    as::asIScriptEngine* engine = script.CreateEngine();
+    TEST_ASSERT(engine);
+
+    as::asIScriptModule* module = Benchmark::BuildModule(engine, Source);
+    TEST_ASSERT(module);
+
+    as::asIScriptFunction* first  = module->GetFunctionByDecl("int First(int)");
+    as::asIScriptFunction* second = module->GetFunctionByDecl("int Second(int)");
+    TEST_ASSERT(first && second);
+
+    int32_t result = 0;
+
+    as::asIScriptContext* firstContext = Run(script, first, 1, result);
+    TEST_ASSERT(firstContext && result == 2);
+
+    // Same function gets same context, still prepared for it
+    as::asIScriptContext* context = script.RequestContext(engine, false, first);
+    TEST_ASSERT(context == firstContext);
+    TEST_ASSERT(context->GetFunction() == first);
+    TEST_ASSERT(context->GetState() == as::asEXECUTION_FINISHED);
+
+    // While first context is in use, other function gets other context
+    as::asIScriptContext* secondContext = Run(script, second, 1, result);
+    TEST_ASSERT(secondContext && secondContext != firstContext && result == 3);
+    ReturnPrepared(context);
+
+    // Context bound to function is found even if it's not on top of pool
+    context = script.RequestContext(engine, false, second);
+    TEST_ASSERT(context == secondContext);
+    TEST_ASSERT(context->GetFunction() == second);
+    ReturnPrepared(context);
+
+    // Pooled contexts must not keep discarded functions prepared
+    TEST_ASSERT(script.UnloadModule(module));
+
+    as::asIScriptContext* pooled[2] = {script.RequestContext(engine, false), script.RequestContext(engine, false)};
+    for(as::asIScriptContext* unbound : pooled)
+    {
+        TEST_ASSERT(unbound == firstContext || unbound == secondContext);
+        TEST_ASSERT(unbound->GetFunction() == nullptr);
+        TEST_ASSERT(unbound->GetState() == as::asEXECUTION_UNINITIALIZED);
+    }
+
+    engine->ReturnContext(pooled[0]);
+    engine->ReturnContext(pooled[1]);
+
+    script.DestroyEngine(engine);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#include "Tilemap.hpp"
+#include "Test.hpp"
+
+// Checks that only chunks overlapping view are returned, and only changed chunks are rebuilt
+
+TEST_MAIN
+{
+    const uint32_t size = Tilemap::ChunkSize;
+
+    Tilemap tilemap;
+    TEST_ASSERT(!tilemap.Create(0, 10, 32, 32));
+    TEST_ASSERT(tilemap.Query(sf::FloatRect(0.0f, 0.0f, 1000.0f, 1000.0f)).empty());
+
+    // 4x3 chunks, last column and row partially filled
+    TEST_ASSERT(tilemap.Create(size * 3 + 5, size * 2 + 1, 32, 32));
+    TEST_ASSERT(tilemap.GetWidth() == size * 3 + 5);
+
+    // Empty chunks are not returned, but are still built
+    TEST_ASSERT(tilemap.Query(sf::FloatRect(0.0f, 0.0f, 10000.0f, 10000.0f)).empty());
+    TEST_ASSERT(tilemap.Rebuilds == 12);
+
+    std::vector<uint32_t> tiles(tilemap.GetWidth() * tilemap.GetHeight(), 1);
+    TEST_ASSERT(!tilemap.SetTiles(tiles.data(), tiles.size() - 1));
+    TEST_ASSERT(tilemap.SetTiles(tiles.data(), tiles.size()));
+
+    // Single chunk is 512x512 pixels
+    const sf::FloatRect view(100.0f, 100.0f, 600.0f, 300.0f);
+
+    const std::vector<const Tilemap::Chunk*>& visible = tilemap.Query(view);
+    TEST_ASSERT(visible.size() == 2);
+    TEST_ASSERT(visible[0]->Vertices.getVertexCount() == size * size * 4);
+    TEST_ASSERT(tilemap.Visible == 2 && tilemap.Culled == 10);
+    TEST_ASSERT(tilemap.Rebuilds == 14);
+
+    // Nothing changed
+    TEST_ASSERT(tilemap.Query(view).size() == 2);
+    TEST_ASSERT(tilemap.Rebuilds == 14);
+
+    // Change outside of view is not rebuilt until chunk becomes visible
+    TEST_ASSERT(tilemap.SetTile(0, 0, 0));
+    TEST_ASSERT(tilemap.SetTile(size * 3, size * 2, 0));
+    TEST_ASSERT(!tilemap.SetTile(size * 3 + 5, 0, 0));
+    TEST_ASSERT(tilemap.GetTile(0, 0) == 0 && tilemap.GetTile(1, 0) == 1);
+
+    TEST_ASSERT(tilemap.Query(view).size() == 2);
+    TEST_ASSERT(tilemap.Rebuilds == 15);
+    TEST_ASSERT(tilemap.Query(view)[0]->Vertices.getVertexCount() == (size * size - 1) * 4);
+
+    // Every chunk still holds at least one tile
+    TEST_ASSERT(tilemap.Query(sf::FloatRect(-10000.0f, -10000.0f, 20000.0f, 20000.0f)).size() == 12);
+    TEST_ASSERT(tilemap.Rebuilds == 25);
+
+    // Moved away from view
+    tilemap.Position = sf::Vector2f(-2000.0f, 0.0f);
+    TEST_ASSERT(tilemap.Query(view).empty());
+    TEST_ASSERT(tilemap.Culled == 12);
+
+    return EXIT_SUCCESS;
+}
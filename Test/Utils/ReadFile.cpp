@@ -0,0 +1,44 @@
+#include "Test.hpp"
+#include "Utils.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    static bool Write(const std::string& filename, const std::string& content)
+    {
+        std::ofstream fstream(filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        fstream << content;
+
+        return fstream.good();
+    }
+}
+
+TEST_MAIN
+{
+    const std::string filename = (std::filesystem::temp_directory_path() / "EWAN.Test.ReadFile.txt").string();
+
+    std::string              content;
+    std::vector<std::string> lines;
+
+    TEST_ASSERT(Write(filename, "one\r\ntwo\r\nthree"));
+    TEST_ASSERT(Utils::ReadFile(filename, content));
+    TEST_ASSERT(content == "one\ntwo\nthree\n");
+    TEST_ASSERT(Utils::ReadFile(filename, lines));
+    TEST_ASSERT(lines.size() == 3);
+
+    // bom is skipped, trailing newline is kept
+    TEST_ASSERT(Write(filename, "\xEF\xBB\xBFone\ntwo\n"));
+    TEST_ASSERT(Utils::ReadFile(filename, content));
+    TEST_ASSERT(content == "one\ntwo\n\n");
+
+    TEST_ASSERT(Write(filename, ""));
+    TEST_ASSERT(Utils::ReadFile(filename, content));
+    TEST_ASSERT(content.empty());
+
+    std::filesystem::remove(filename);
+    TEST_ASSERT(!Utils::ReadFile(filename, content));
+
+    return EXIT_SUCCESS;
+}